@@ -0,0 +1,175 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Мини-харнесс бенчмарков: ns/op, аллокации и байты на операцию, перцентили времени сэмпла (кадра), JSON.
+// Подсчёт аллокаций работает, если в программе подменены operator new/delete (BENCH_COUNT_ALLOCATIONS -> alloc_tracker.h).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+#define ALLOC_TRACKER_HOOK
+#endif
+#include "../sdk/hpp/alloc_tracker.h"
+
+namespace Bench {
+
+    struct Result {
+        std::string name;
+        uint64_t ops = 0;        // всего операций в замере
+        uint64_t samples = 0;    // сэмплов (кадров)
+        double nsPerOp = 0;
+        double allocsPerOp = 0;
+        double bytesPerOp = 0;
+        double allocBudget = -1; // allocs/op; < 0 - без бюджета
+        bool overBudget = false;
+        double p50 = 0, p90 = 0, p99 = 0, max = 0; // нс на сэмпл
+    };
+
+    struct Options {
+        const char* filter = nullptr; // подстрока имени
+        const char* jsonPath = nullptr;
+        double minSeconds = 0.25;     // время замера одного бенчмарка
+        uint64_t maxSamples = 100000;
+        bool checkBudgets = false;    // тестовый режим: превышение бюджета аллокаций - ненулевой код выхода
+    };
+
+    class Suite {
+    public:
+        explicit Suite(const Options& benchOptions) : options(benchOptions) {
+            std::printf("%-34s %12s %10s %10s %12s %12s %12s\n", "benchmark", "ns/op", "allocs/op", "bytes/op", "p50 ns", "p99 ns", "max ns");
+        }
+
+        bool selected(const std::string& name) const {
+            return !options.filter || name.find(options.filter) != std::string::npos;
+        }
+
+        // sample() выполняет opsPerSample операций (например, один кадр на N анимаций);
+        // allocBudget - допустимые allocs/op горячего пути, проверяется с --check-budgets
+        template <class Fn>
+        void run(const std::string& name, uint64_t opsPerSample, Fn&& sample, double allocBudget = -1) {
+            if (!selected(name)) return;
+
+            sample(); // прогрев: ёмкости буферов, таблицы, кэши
+
+            std::vector<double> times;
+            times.reserve(options.maxSamples); // заранее - рост вектора не попадает в allocs/op
+            const uint64_t allocsBefore = AllocTracker::totalAllocations();
+            const uint64_t bytesBefore = AllocTracker::totalAllocatedBytes();
+            double total = 0;
+            while ((total < options.minSeconds || times.size() < 5) && times.size() < options.maxSamples) {
+                const auto begin = std::chrono::steady_clock::now();
+                sample();
+                const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+                times.push_back(ns);
+                total += ns * 1e-9;
+            }
+            const uint64_t allocs = AllocTracker::totalAllocations() - allocsBefore;
+            const uint64_t bytes = AllocTracker::totalAllocatedBytes() - bytesBefore;
+
+            Result r;
+            r.name = name;
+            r.samples = times.size();
+            r.ops = r.samples * opsPerSample;
+            r.nsPerOp = total * 1e9 / static_cast<double>(r.ops);
+            r.allocsPerOp = static_cast<double>(allocs) / static_cast<double>(r.ops);
+            r.bytesPerOp = static_cast<double>(bytes) / static_cast<double>(r.ops);
+            r.allocBudget = allocBudget;
+            r.overBudget = allocBudget >= 0 && r.allocsPerOp > allocBudget;
+
+            std::sort(times.begin(), times.end());
+            auto at = [&](double q) { return times[std::min(times.size() - 1, static_cast<size_t>(q * times.size()))]; };
+            r.p50 = at(0.5);
+            r.p90 = at(0.9);
+            r.p99 = at(0.99);
+            r.max = times.back();
+
+            std::printf("%-34s %12.2f %10.3f %10.1f %12.0f %12.0f %12.0f%s\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp,
+                        r.bytesPerOp, r.p50, r.p99, r.max, r.overBudget ? "  OVER ALLOC BUDGET" : "");
+            results.push_back(r);
+        }
+
+        // Все бюджеты соблюдены (или проверка выключена)
+        bool budgetsPassed() const {
+            if (!options.checkBudgets) return true;
+            bool passed = true;
+            for (const Result& r : results) {
+                if (!r.overBudget) continue;
+                std::fprintf(stderr, "%s: %.3f allocs/op, budget %.3f\n", r.name.c_str(), r.allocsPerOp, r.allocBudget);
+                passed = false;
+            }
+            return passed;
+        }
+
+        // Инвариант, на котором держится замер (например, один вызов отрисовки на страницу); проверяется всегда
+        void check(const std::string& name, bool ok) {
+            if (ok) return;
+            std::fprintf(stderr, "%s: check failed\n", name.c_str());
+            failedChecks.push_back(name);
+        }
+
+        bool checksPassed() const { return failedChecks.empty(); }
+
+        // {"benchmarks":[{...}]} - формат для сравнения между релизами
+        bool writeJson() const {
+            if (!options.jsonPath) return true;
+            FILE* file = std::fopen(options.jsonPath, "w");
+            if (!file) {
+                std::fprintf(stderr, "cannot write %s\n", options.jsonPath);
+                return false;
+            }
+            std::fprintf(file, "{\n  \"benchmarks\": [\n");
+            for (size_t i = 0; i < results.size(); ++i) {
+                const Result& r = results[i];
+                std::fprintf(file,
+                             "    {\"name\": \"%s\", \"ops\": %llu, \"samples\": %llu, \"ns_per_op\": %.4f, "
+                             "\"allocs_per_op\": %.6f, \"bytes_per_op\": %.2f, \"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f}%s\n",
+                             r.name.c_str(), (unsigned long long)r.ops, (unsigned long long)r.samples, r.nsPerOp,
+                             r.allocsPerOp, r.bytesPerOp, r.p50, r.p90, r.p99, r.max, i + 1 < results.size() ? "," : "");
+            }
+            std::fprintf(file, "  ]\n}\n");
+            std::fclose(file);
+            return true;
+        }
+
+    private:
+        Options options;
+        std::vector<Result> results;
+        std::vector<std::string> failedChecks;
+    };
+
+    // --filter S, --json PATH, --seconds T, --check-budgets
+    inline bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const bool hasValue = i + 1 < argc;
+            if (!std::strcmp(argv[i], "--filter") && hasValue) {
+                options.filter = argv[++i];
+            } else if (!std::strcmp(argv[i], "--json") && hasValue) {
+                options.jsonPath = argv[++i];
+            } else if (!std::strcmp(argv[i], "--seconds") && hasValue) {
+                options.minSeconds = std::strtod(argv[++i], nullptr);
+            } else if (!std::strcmp(argv[i], "--check-budgets")) {
+                options.checkBudgets = true;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Не даёт компилятору выбросить результат (переносимо, без asm)
+    template <class T>
+    inline void keep(T value) {
+        static volatile T sink;
+        sink = value;
+        (void)sink;
+    }
+}
+
+#endif
@@ -0,0 +1,164 @@
+// Конкуренция за очередь команд анимации: мьютекс + вектор против lock-free MpscQueue
+//   bench_command_queue [commands]
+// Писатели (1, 4, 16 потоков) шлют команды, рендер-поток разбирает их "кадрами".
+// Обе очереди вмещают batch команд, так что кадр разбирает одинаковый объём и писатели ждут одинаково.
+// Считается пропускная способность, время одного tryPush у писателя (там и спорят за очередь)
+// и время разбора за кадр (то, что видит рендер-поток).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../sdk/hpp/command_queue.h"
+
+constexpr size_t batch = 1024; // ёмкость обеих очередей - не больше стольких команд за кадр
+
+// Полезная нагрузка размером с команду move(): виджет, цель, длительность
+struct MoveCommand {
+    uint32_t widget = 0;
+    float x = 0, y = 0, duration = 0;
+};
+
+// Прежняя схема: каждый вызов и каждый кадр берут общий мьютекс; ограничена batch, как и кольцо
+class MutexQueue {
+public:
+    MutexQueue() {
+        pending.reserve(batch);
+        frame.reserve(batch);
+    }
+
+    bool tryPush(MoveCommand&& command) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending.size() == batch) return false;
+        pending.push_back(command);
+        return true;
+    }
+
+    template <class Fn>
+    size_t drain(Fn&& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            frame.swap(pending);
+        }
+        for (const MoveCommand& command : frame) fn(command);
+        const size_t count = frame.size();
+        frame.clear();
+        return count;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<MoveCommand> pending, frame;
+};
+
+class RingQueue {
+public:
+    bool tryPush(MoveCommand&& command) { return ring.tryPush(std::move(command)); }
+
+    template <class Fn>
+    size_t drain(Fn&& fn) {
+        size_t count = 0;
+        MoveCommand command;
+        while (ring.tryPop(command)) {
+            fn(command);
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    MpscQueue<MoveCommand, batch> ring;
+};
+
+struct Result {
+    double seconds;
+    double pushP50, pushP99;             // нс на один вызов tryPush (удачный или нет)
+    double frameP50, frameP99, frameMax; // мкс на разбор очереди за кадр
+    uint64_t checksum;
+};
+
+template <class T>
+static T percentile(std::vector<T>& values, double q) {
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, size_t(q * values.size()))];
+}
+
+template <class Queue>
+static Result run(size_t commands, unsigned producers) {
+    Queue queue;
+    std::vector<std::thread> threads;
+    const size_t perProducer = commands / producers;
+
+    // Каждый 16-й вызов tryPush замеряется; выборки заведены заранее, чтобы не мерить аллокации
+    constexpr size_t sampleEvery = 16;
+    std::vector<std::vector<double>> pushSamples(producers);
+    for (std::vector<double>& samples : pushSamples) samples.reserve(perProducer / sampleEvery * 2 + 16);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::vector<double>& samples = pushSamples[p];
+            size_t calls = 0;
+            for (size_t i = 0; i < perProducer; ++i) {
+                MoveCommand command{ p, float(i), float(i), 0.5f };
+                for (;;) {
+                    bool pushed;
+                    if (++calls % sampleEvery == 0 && samples.size() < samples.capacity()) {
+                        const auto pushBegin = std::chrono::steady_clock::now();
+                        pushed = queue.tryPush(std::move(command));
+                        samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - pushBegin).count());
+                    } else {
+                        pushed = queue.tryPush(std::move(command));
+                    }
+                    if (pushed) break;
+                    std::this_thread::yield(); // очередь полна - ждём кадра
+                }
+            }
+        });
+    }
+
+    std::vector<double> frames;
+    uint64_t checksum = 0;
+    size_t received = 0;
+    const size_t total = perProducer * producers;
+    while (received < total) {
+        auto frameBegin = std::chrono::steady_clock::now();
+        const size_t drained = queue.drain([&](const MoveCommand& c) { checksum += c.widget + uint64_t(c.x); });
+        frames.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameBegin).count());
+        received += drained;
+        // Остаток кадра рендер-поток занят другим - отдаём ядро писателям
+        if (!drained) std::this_thread::yield();
+    }
+    for (auto& thread : threads) thread.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<double> pushes;
+    for (const std::vector<double>& samples : pushSamples) pushes.insert(pushes.end(), samples.begin(), samples.end());
+    return Result{ seconds, percentile(pushes, 0.5), percentile(pushes, 0.99),
+                   percentile(frames, 0.5), percentile(frames, 0.99), frames.back(), checksum };
+}
+
+int main(int argc, char** argv) {
+    const size_t commands = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const unsigned producerCounts[] = { 1, 4, 16 };
+
+    std::printf("%-8s %9s %12s %12s %12s %12s %12s %12s\n", "queue", "producers", "M cmds/s",
+                "push p50 ns", "push p99 ns", "drain p50 us", "drain p99 us", "drain max us");
+    for (unsigned producers : producerCounts) {
+        const Result mutex = run<MutexQueue>(commands, producers);
+        const Result ring = run<RingQueue>(commands, producers);
+        const double sent = double(commands / producers * producers);
+
+        std::printf("%-8s %9u %12.2f %12.0f %12.0f %12.2f %12.2f %12.2f\n", "mutex", producers, sent / mutex.seconds / 1e6,
+                    mutex.pushP50, mutex.pushP99, mutex.frameP50, mutex.frameP99, mutex.frameMax);
+        std::printf("%-8s %9u %12.2f %12.0f %12.0f %12.2f %12.2f %12.2f  %s\n", "mpsc", producers, sent / ring.seconds / 1e6,
+                    ring.pushP50, ring.pushP99, ring.frameP50, ring.frameP99, ring.frameMax,
+                    mutex.checksum == ring.checksum ? "same commands" : "MISMATCH");
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Бенчмарк пакетного ядра DiceKernel против скалярного play()
+//   bench_dice_kernel [rounds]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "../sdk/hpp/dice_kernel.h"
+
+// Скалярный путь play() из main.cpp: 4 randsh, суммы short и запись строки в who_win
+static std::string who_win_mass[] = { "pl1 win", "pl2 win", "draw" }, who_win;
+
+static void randsh(short& result, short one, short two) {
+    result = static_cast<short>(RandomSystem::local().uniformInt(one, two));
+}
+
+static int play_scalar() {
+    short number_cube1_pl1, number_cube2_pl1, number_cube1_pl2, number_cube2_pl2;
+    randsh(number_cube1_pl1, 1, 6);
+    randsh(number_cube2_pl1, 1, 6);
+
+    randsh(number_cube1_pl2, 1, 6);
+    randsh(number_cube2_pl2, 1, 6);
+
+    short number_cubes_pl1 = number_cube1_pl1 + number_cube2_pl1;
+    short number_cubes_pl2 = number_cube1_pl2 + number_cube2_pl2;
+
+    if (number_cubes_pl1 > number_cubes_pl2) {
+        who_win = who_win_mass[0];
+    }
+    if (number_cubes_pl1 < number_cubes_pl2) {
+        who_win = who_win_mass[1];
+    }
+    if (number_cubes_pl1 == number_cubes_pl2) {
+        who_win = who_win_mass[2];
+    }
+    return who_win.size() == who_win_mass[2].size() ? 2 : (who_win[2] == '1' ? 0 : 1);
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(int argc, char** argv) {
+    const size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+
+    {
+        RandomSystem::seed(1);
+        size_t counts[3] = {};
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; ++i) {
+            ++counts[play_scalar()];
+        }
+        double s = seconds_since(begin);
+        std::printf("%-14s %8.1f M rounds/s  %6.2f ns/round  win %.4f lose %.4f draw %.4f\n", "play() scalar",
+                    rounds / s / 1e6, s * 1e9 / rounds,
+                    double(counts[0]) / rounds, double(counts[1]) / rounds, double(counts[2]) / rounds);
+    }
+
+    const DiceKernel::Path paths[] = { DiceKernel::Path::Scalar, DiceKernel::Path::SSE2, DiceKernel::Path::AVX2 };
+    auto batch = std::make_unique<DiceBatch>();
+    auto reference = std::make_unique<DiceBatch>();
+    FastRandom check(99);
+    DiceKernel::play(check, *reference, DiceBatch::capacity, DiceKernel::Path::Scalar);
+
+    for (DiceKernel::Path path : paths) {
+        if (path > DiceKernel::bestPath()) continue;
+
+        // Все пути должны давать побайтно одинаковый результат
+        check.reseed(99);
+        DiceKernel::play(check, *batch, DiceBatch::capacity, path);
+        const bool same = !std::memcmp(batch->outcomes, reference->outcomes, DiceBatch::capacity) &&
+                          !std::memcmp(batch->faces, reference->faces, sizeof(batch->faces));
+
+        FastRandom rng(1);
+        size_t counts[3] = {};
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < rounds; done += DiceBatch::capacity) {
+            DiceKernel::play(rng, *batch, DiceBatch::capacity, path);
+            for (size_t i = 0; i < batch->rounds; ++i) {
+                ++counts[batch->outcomes[i]];
+            }
+        }
+        const size_t played = (rounds + DiceBatch::capacity - 1) / DiceBatch::capacity * DiceBatch::capacity;
+        double s = seconds_since(begin);
+        std::printf("%-14s %8.1f M rounds/s  %6.2f ns/round  win %.4f lose %.4f draw %.4f  %s\n",
+                    DiceKernel::pathName(path), played / s / 1e6, s * 1e9 / played,
+                    double(counts[0]) / played, double(counts[1]) / played, double(counts[2]) / played,
+                    same ? "matches scalar" : "MISMATCH");
+    }
+
+    return 0;
+}
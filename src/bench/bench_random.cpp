@@ -0,0 +1,81 @@
+// Микробенчмарк рандомайзера: броски кубика в секунду до и после RandomSystem
+//   bench_random [rolls]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../sdk/hpp/random_system.h"
+
+// Старый randsh(): random_device + новый mt19937 на каждый вызов
+static void legacy_randsh(short& result, short one, short two) {
+    std::random_device rd;
+    std::mt19937 rand(rd());
+
+    std::uniform_int_distribution<short> dist(one, two);
+
+    result = dist(rand);
+}
+
+template <class Fn>
+static void report(const char* name, size_t rolls, Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    long long checksum = fn();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::printf("%-28s %14.0f rolls/s  %8.2f ns/roll  (checksum %lld)\n",
+                name, rolls / seconds, seconds * 1e9 / rolls, checksum);
+}
+
+int main(int argc, char** argv) {
+    const size_t rolls = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    // random_device на каждый вызов слишком медленный для полного прогона
+    const size_t legacyRolls = rolls / 100 > 0 ? rolls / 100 : 1;
+
+    report("legacy randsh", legacyRolls, [&] {
+        long long sum = 0;
+        short face;
+        for (size_t i = 0; i < legacyRolls; ++i) {
+            legacy_randsh(face, 1, 6);
+            sum += face;
+        }
+        return sum;
+    });
+
+    report("MtRandom::uniformInt", rolls, [&] {
+        MtRandom rng(42);
+        long long sum = 0;
+        for (size_t i = 0; i < rolls; ++i) {
+            sum += rng.uniformInt(1, 6);
+        }
+        return sum;
+    });
+
+    report("FastRandom::uniformInt", rolls, [&] {
+        FastRandom& rng = RandomSystem::local();
+        rng.reseed(42);
+        long long sum = 0;
+        for (size_t i = 0; i < rolls; ++i) {
+            sum += rng.uniformInt(1, 6);
+        }
+        return sum;
+    });
+
+    report("FastRandom::rollDice", rolls, [&] {
+        FastRandom& rng = RandomSystem::local();
+        rng.reseed(42);
+        std::vector<short> faces(4096);
+        long long sum = 0;
+        for (size_t done = 0; done < rolls; done += faces.size()) {
+            rng.rollDice(faces.data(), faces.size());
+            for (short f : faces) {
+                sum += f;
+            }
+        }
+        return sum;
+    });
+
+    return 0;
+}
@@ -0,0 +1,344 @@
+// Набор бенчмарков горячих путей: анимации, easing, раунды игры, раскладка при ресайзе, спрайты, частицы, кубики
+//   benchmark [--filter S] [--json out.json] [--seconds T] [--check-budgets]
+// Печатает ns/op, allocs/op, bytes/op и перцентили времени сэмпла (кадра); --json пишет то же для сравнения релизов.
+// --check-budgets: горячие пути с бюджетом аллокаций (0 - без кучи) при превышении дают код выхода 2.
+// Проверки инвариантов (например, спрайты одной страницы атласа - один вызов отрисовки) при провале дают код выхода 3.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench.h"
+
+#include <TGUI/TGUI.hpp>
+#include <TGUI/Backend/SFML-Graphics.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../sdk/hpp/animation_system.h"
+#include "../sdk/hpp/game_core.h"
+#include "../sdk/hpp/dice_kernel.h"
+#include "../sdk/hpp/scene_layout.h"
+#include "../sdk/hpp/layout_system.h"
+#include "../sdk/hpp/sprite_batch.h"
+#include "../sdk/hpp/asset_loader.h"
+#include "../sdk/hpp/particle_system.h"
+#include "../sdk/hpp/dice_physics.h"
+
+static const char* easingNames[EasingFunctions::typeCount] = {
+    "linear", "ease_in", "ease_out", "ease_in_out", "bounce_in",
+    "bounce_out", "elastic_in", "elastic_out", "back_in", "back_out"
+};
+
+static std::string countName(size_t n) {
+    if (n >= 1000000) return std::to_string(n / 1000000) + "m";
+    if (n >= 1000) return std::to_string(n / 1000) + "k";
+    return std::to_string(n);
+}
+
+// updateAnimations на N одновременных анимациях, виртуальное время - кадр 1/60 с
+static void benchAnimation(Bench::Suite& suite) {
+    const size_t counts[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+
+    // Виджеты общие: на один виджет может приходиться много анимаций, память не растёт с N
+    std::vector<tgui::Widget::Ptr> widgets;
+    for (size_t i = 0; i < 1024; ++i) {
+        widgets.push_back(tgui::Picture::create());
+    }
+
+    for (size_t count : counts) {
+        const std::string name = "anim/update/" + countName(count);
+        if (!suite.selected(name)) continue;
+
+        AnimationSystem::initialize(ClockMode::Manual);
+        for (size_t i = 0; i < count; ++i) {
+            // Длинные анимации всех типов easing - за время замера ни одна не закончится
+            AnimationSystem::move(widgets[i % widgets.size()], { float(i % 1000), float(i % 500) }, 1e6f,
+                                  static_cast<EasingType>(i % EasingFunctions::typeCount));
+        }
+        suite.run(name, count, [] { AnimationSystem::step(1.0 / 60); }, 0);
+        AnimationSystem::shutdown();
+    }
+
+    // Запуск и завершение коротких анимаций: push, сегмент, callback, уплотнение
+    AnimationSystem::initialize(ClockMode::Manual);
+    int completed = 0;
+    suite.run("anim/start_finish/1k", 1000, [&] {
+        for (size_t i = 0; i < 1000; ++i) {
+            AnimationSystem::moveWithCallback(widgets[i], { 1, 1 }, 0.01f, [&completed] { ++completed; });
+        }
+        AnimationSystem::step(0.02);
+    }, 0);
+    Bench::keep(completed);
+    AnimationSystem::shutdown();
+}
+
+// Каждая кривая: пакетный путь updateAnimations и скалярный applyEasing
+static void benchEasing(Bench::Suite& suite) {
+    const size_t count = 4096;
+    std::vector<float> progress(count), eased(count);
+    for (size_t i = 0; i < count; ++i) {
+        progress[i] = static_cast<float>(i) / (count - 1);
+    }
+
+    for (size_t type = 0; type < EasingFunctions::typeCount; ++type) {
+        const EasingType easing = static_cast<EasingType>(type);
+        suite.run(std::string("easing/batch/") + easingNames[type], count, [&] {
+            EasingFunctions::applyBatch(easing, progress.data(), eased.data(), count);
+            Bench::keep(eased[count / 2]);
+        }, 0);
+        suite.run(std::string("easing/scalar/") + easingNames[type], count, [&] {
+            for (size_t i = 0; i < count; ++i) {
+                eased[i] = EasingFunctions::applyEasing(easing, progress[i]);
+            }
+            Bench::keep(eased[count / 2]);
+        }, 0);
+    }
+}
+
+// Раунды игры: то, что делает play() по кнопке, без вывода в консоль
+static void benchGame(Bench::Suite& suite) {
+    const size_t rounds = 1000;
+
+    Match match(1);
+    suite.run("game/match_play", rounds, [&] {
+        unsigned events = 0;
+        for (size_t i = 0; i < rounds; ++i) {
+            events += static_cast<unsigned>(match.play());
+        }
+        Bench::keep(events);
+    }, 0);
+
+    FastRandom rng(2);
+    GameState state;
+    GameCore::reset(state, rng);
+    suite.run("game/core_step", rounds, [&] {
+        for (size_t i = 0; i < rounds; ++i) {
+            if (state.over()) GameCore::reset(state, rng);
+            GameCore::step(state, rng);
+        }
+        Bench::keep(state.round);
+    }, 0);
+
+    auto batch = std::make_unique<DiceBatch>();
+    FastRandom kernelRng(3);
+    suite.run("game/kernel_rounds", DiceBatch::capacity, [&] {
+        DiceKernel::play(kernelRng, *batch, DiceBatch::capacity);
+        Bench::keep(batch->outcomes[0]);
+    }, 0);
+}
+
+// Шторм ресайзов: прежний пересчёт на каждое событие против LayoutSystem (один пересчёт за кадр)
+static void benchLayout(Bench::Suite& suite, tgui::Gui& gui) {
+    tgui::Widget::Ptr widgets[SceneLayout::SlotCount];
+    for (size_t i = 0; i < SceneLayout::BtnTap; ++i) {
+        widgets[i] = tgui::Picture::create();
+        gui.add(widgets[i]);
+    }
+    auto button = tgui::Button::create("Click me!");
+    gui.add(button);
+    widgets[SceneLayout::BtnTap] = button;
+
+    auto scorePl1 = tgui::Label::create("(pl1) score: 0");
+    auto scorePl2 = tgui::Label::create("(pl2) score: 0");
+    gui.add(scorePl1);
+    gui.add(scorePl2);
+
+    const size_t resizes = 64;
+    unsigned frame = 0;
+    suite.run("layout/resize_storm", resizes, [&] {
+        for (size_t i = 0; i < resizes; ++i, ++frame) {
+            // Перетаскивание угла окна: размер меняется каждое событие
+            const float width = 640.0f + static_cast<float>((frame * 37) % 1280);
+            const float height = 360.0f + static_cast<float>((frame * 23) % 720);
+            const LayoutTransform layout = SceneLayout::apply(width, height, widgets);
+
+            const unsigned int textSize = static_cast<unsigned int>(16 * layout.scale);
+            scorePl1->setTextSize(textSize);
+            scorePl2->setTextSize(textSize);
+            button->setTextSize(static_cast<unsigned int>(28 * layout.scale));
+        }
+    });
+
+    LayoutSystem system;
+    system.loadDefaults();
+    static const char* names[SceneLayout::SlotCount] = {
+        "cup_pl1", "cup_pl2", "left_hand_pl1", "right_hand_pl1", "left_hand_pl2", "right_hand_pl2", "revolver", "muzzle_flash", "btn_tap"
+    };
+    for (size_t i = 0; i < SceneLayout::SlotCount; ++i) system.bind(names[i], widgets[i]);
+    system.bind("score_pl1", scorePl1);
+    system.bind("score_pl2", scorePl2);
+
+    // Те же события, ~8 за кадр: resize() только запоминает размер, update() - раз в кадр
+    const size_t eventsPerFrame = 8;
+    frame = 0;
+    suite.run("layout/resize_storm_coalesced", resizes, [&] {
+        for (size_t i = 0; i < resizes; ++i, ++frame) {
+            system.resize(640.0f + static_cast<float>((frame * 37) % 1280), 360.0f + static_cast<float>((frame * 23) % 720));
+            if (i % eventsPerFrame == eventsPerFrame - 1) Bench::keep(system.update());
+        }
+    });
+
+    // Кадр без ресайза - проход по флагам без вызовов виджетов
+    suite.run("layout/idle_frame", 1, [&] {
+        Bench::keep(system.update());
+    }, 0);
+
+    gui.removeAllWidgets();
+}
+
+// Слой фишек: 64 куска одной страницы атласа, все сдвигаются каждый кадр (как при анимации бросков)
+static void benchSprites(Bench::Suite& suite, sf::RenderTarget& target) {
+    // Спрайты получают картинки как в игре: куски одной страницы через AssetLoader.
+    // Страница - временный файл 64x64, сетка 8x8 кусков по 8x8
+    const std::string pagePath = (std::filesystem::temp_directory_path() / "benchmark_atlas_page.png").string();
+    const sf::Image pageImage({ 64, 64 }, sf::Color::White);
+    suite.check("sprites/page_written", pageImage.saveToFile(pagePath));
+
+    const size_t count = 64;
+    SpriteBatch batch;
+    AssetLoader loader(1);
+    for (size_t i = 0; i < count; ++i) {
+        tgui::Widget::Ptr node = SpriteBatch::createNode();
+        node->setSize(32, 32);
+        const SpriteBatch::Sprite sprite = batch.add(node);
+        const tgui::UIntRect part(static_cast<unsigned>(i % 8) * 8, static_cast<unsigned>(i / 8) * 8, 8, 8);
+        loader.request(pagePath, AssetPriority::Critical, [&batch, sprite](const tgui::Texture& page, const tgui::UIntRect& rect) {
+            batch.setImage(sprite, page, rect);
+        }, part);
+    }
+    while (!loader.idle()) {
+        loader.pump(1);
+        std::this_thread::yield();
+    }
+    std::remove(pagePath.c_str());
+    const tgui::FloatRect view{ 0, 0, SceneLayout::originalWidth, SceneLayout::originalHeight };
+
+    // Все куски одной страницы - одна текстура, значит один вызов отрисовки
+    batch.sync();
+    suite.check("sprites/draw_64_one_call", batch.drawCalls() == 1);
+
+    unsigned frame = 0;
+    suite.run("sprites/sync_64_moving", count, [&] {
+        ++frame;
+        for (size_t i = 0; i < count; ++i) {
+            batch.node(static_cast<SpriteBatch::Sprite>(i))->setPosition(static_cast<float>((frame + i * 13) % 1024), 256.0f);
+        }
+        Bench::keep(batch.sync());
+    }, 0);
+
+    suite.run("sprites/sync_idle", count, [&] {
+        Bench::keep(batch.sync());
+    }, 0);
+
+    suite.run("sprites/draw_64", count, [&] {
+        batch.draw(target, view);
+        Bench::keep(batch.drawCalls());
+    });
+}
+
+// 50k живых частиц: полный update() (движение, вершины, загрузка в буфер) по путям; выброс и вымирание - без кучи
+static void benchParticles(Bench::Suite& suite, sf::RenderTarget& target) {
+    const uint8_t pixels[4 * 4 * 4] = {};
+    tgui::Texture sheet;
+    sheet.loadFromPixelData({ 4, 4 }, pixels);
+    const tgui::FloatRect view{ 0, 0, SceneLayout::originalWidth, SceneLayout::originalHeight };
+
+    const size_t count = 50000;
+    ParticleSystem particles(count);
+    particles.addKind(sheet);
+    particles.setGravity(0, 600);
+    particles.setDrag(1);
+    FastRandom rng(4);
+
+    // Живут дольше прогона - число частиц не меняется
+    ParticleBurst steady;
+    steady.x = SceneLayout::originalWidth / 2;
+    steady.y = SceneLayout::originalHeight / 2;
+    steady.speedMax = 400;
+    steady.spinMax = 10;
+    steady.lifeMin = steady.lifeMax = 1e6f;
+    particles.spawn(steady, count, rng);
+
+    for (ParticleSystem::Path path : { ParticleSystem::Path::Scalar, ParticleSystem::bestPath() }) {
+        suite.run(std::string("particles/update_50k/") + ParticleSystem::pathName(path), count, [&] {
+            Bench::keep(particles.update(1.0f / 60, path));
+        }, 0);
+    }
+
+    suite.run("particles/draw_50k", count, [&] {
+        particles.draw(target, view);
+        Bench::keep(particles.size());
+    });
+
+    // Выброс 256 частиц, которые гаснут в том же кадре
+    ParticleSystem pool(4096);
+    ParticleBurst burst = steady;
+    burst.lifeMin = burst.lifeMax = 0.01f;
+    suite.run("particles/spawn_retire_256", 256, [&] {
+        pool.spawn(burst, 256, rng);
+        Bench::keep(pool.update(1.0f / 60));
+    }, 0);
+}
+
+// Кубики: шаг мира на 32 кубика и бросок раунда целиком (4 кубика, прогон до остановки в steer())
+static void benchDice(Bench::Suite& suite) {
+    FastRandom rng(5);
+    DiceThrow scatter;
+    scatter.x = SceneLayout::originalWidth / 2;
+    scatter.y = SceneLayout::originalHeight / 2;
+    scatter.spread = 6.2831853f;
+    scatter.scatter = 200;
+
+    DicePhysics world;
+    suite.run("dice/step_32", DicePhysics::maxDice, [&] {
+        if (!world.busy()) {
+            world.reset(DiceTable{ 0, 0, SceneLayout::originalWidth, SceneLayout::originalHeight });
+            world.throwDice(scatter, DicePhysics::maxDice, rng);
+        }
+        Bench::keep(world.step());
+    }, 0);
+
+    const uint8_t wanted[4] = { 1, 6, 3, 4 };
+    suite.run("dice/throw_steer_4", 4, [&] {
+        DicePhysics round;
+        round.reset(DiceTable{ 260, 40, 764, 472 });
+        DiceThrow cup = scatter;
+        cup.spread = 0.6f;
+        cup.scatter = 20;
+        cup.direction = -1.5708f;
+        round.throwDice(cup, 2, rng);
+        cup.direction = 1.5708f;
+        round.throwDice(cup, 2, rng);
+        round.steer(wanted, 4);
+        Bench::keep(round.face(0));
+    }, 0);
+}
+
+int main(int argc, char** argv) {
+    Bench::Options options;
+    if (!Bench::parseOptions(argc, argv, options)) {
+        std::printf("usage: benchmark [--filter S] [--json out.json] [--seconds T] [--check-budgets]\n");
+        return 1;
+    }
+
+    // Невидимая цель отрисовки: виджетам TGUI нужен backend, окно не нужно
+    sf::RenderTexture target({ static_cast<unsigned>(SceneLayout::originalWidth),
+                               static_cast<unsigned>(SceneLayout::originalHeight) });
+    tgui::Gui gui{ target };
+
+    Bench::Suite suite(options);
+    benchAnimation(suite);
+    benchEasing(suite);
+    benchGame(suite);
+    benchLayout(suite, gui);
+    benchSprites(suite, target);
+    benchParticles(suite, target);
+    benchDice(suite);
+
+    if (!suite.writeJson()) return 1;
+    if (!suite.checksPassed()) return 3;
+    return suite.budgetsPassed() ? 0 : 2;
+}
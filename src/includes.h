@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdio>
 #include <string>
 #include <random>
 #include <chrono>
@@ -8,4 +9,20 @@
 #include "sdk\TGUI-1.10\include\TGUI\TGUI.hpp"
 #include "sdk\TGUI-1.10\include\TGUI\Backend\SFML-Graphics.hpp"
 
-#include "sdk\hpp\animation_system.h"
\ No newline at end of file
+#include "sdk\hpp\alloc_tracker.h"
+#include "sdk\hpp\profiler_overlay.h"
+#include "sdk\hpp\timer_wheel.h"
+#include "sdk\hpp\animation_system.h"
+#include "sdk\hpp\random_system.h"
+#include "sdk\hpp\game_core.h"
+#include "sdk\hpp\scene_layout.h"
+#include "sdk\hpp\texture_atlas.h"
+#include "sdk\hpp\asset_pack.h"
+#include "sdk\hpp\asset_loader.h"
+#include "sdk\hpp\resource_cache.h"
+#include "sdk\hpp\layout_system.h"
+#include "sdk\hpp\render_scheduler.h"
+#include "sdk\hpp\sprite_batch.h"
+#include "sdk\hpp\frame_animation.h"
+#include "sdk\hpp\particle_system.h"
+#include "sdk\hpp\dice_physics.h"
\ No newline at end of file
@@ -11,18 +11,17 @@ using namespace sf;
 /////////////////////
  
 // variables
-static short score_pl1_short = 0, score_pl2_short = 0, \
-             number_cube1_pl1, number_cube1_pl2, \
-             number_cube2_pl1, number_cube2_pl2, \
-             number_cubes_pl1, number_cubes_pl2;
+static Match match; // всё состояние игры - в game_core.h
 
-static string pl1_name = "pl1", pl2_name = "pl2", full_text_1, full_text_2;
+static const char* pl1_name = "pl1", * pl2_name = "pl2";
+static char full_text_1[32], full_text_2[32];
 
-string who_win_mass[] = { "pl1 win", "pl2 win", "draw" }, who_win;
+const char* who_win_mass[] = { "pl1 win", "pl2 win", "draw" };
 
 
 /* timer()
-вызов таймера: timer(2.9); | где timer() - функция, а 2.9 - время в секундах
+вызов таймера: timer(2.9, []{ ... }); | где timer() - функция, 2.9 - время в секундах, а {...} - что сделать потом
+                                      | отмена: AnimationSystem::cancel(handle)
 */
 
 /* randi()
@@ -47,115 +46,242 @@ string who_win_mass[] = { "pl1 win", "pl2 win", "draw" }, who_win;
 */
 
 
-void timer(double seconds) {
-    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+// Не блокирует поток: callback вызовется из главного цикла через seconds секунд по часам анимаций -
+// то же колесо и те же часы, что у дорожек AnimationSystem, кадров и частиц
+TimerHandle timer(double seconds, TimerCallback callback) {
+    return AnimationSystem::after(seconds, std::move(callback));
 }
 
+// Генератор общий на поток (RandomSystem::local()), повторяемость - через RandomSystem::seed(...)
 void randi(int& result, int one, int two) {
-    random_device rd;
-    mt19937 rand(rd());
-
-    uniform_int_distribution<int> dist(one, two);
-
-    result = dist(rand);
+    result = RandomSystem::local().uniformInt(one, two);
 }
 void randsh(short& result, short one, short two) {
-    random_device rd;
-    mt19937 rand(rd());
-
-    uniform_int_distribution<short> dist(one, two);
-
-    result = dist(rand);
+    result = static_cast<short>(RandomSystem::local().uniformInt(one, two));
 }
 void randf(float& result, float one, float two) {
-    random_device rd;
-    mt19937 rand(rd());
-
-    uniform_real_distribution<float> dist(one, two);
-
-    result = dist(rand);
+    result = RandomSystem::local().uniformFloat(one, two);
 }
 
 
-void play() {
-    randsh(number_cube1_pl1, 1, 6);
-    randsh(number_cube2_pl1, 1, 6);
-
-    randsh(number_cube1_pl2, 1, 6);
-    randsh(number_cube2_pl2, 1, 6);
+// Текст счёта в буфер без временных string: "(pl1) score: 3"
+const char* score_text(char (&buffer)[32], const char* name, short score) {
+    snprintf(buffer, sizeof(buffer), "(%s) score: %d", name, score);
+    return buffer;
+}
 
-    number_cubes_pl1 = number_cube1_pl1 + number_cube2_pl1;
-    number_cubes_pl2 = number_cube1_pl2 + number_cube2_pl2;
+GameEvent play() {
+    ALLOC_SCOPE("play");
+    GameEvent events = match.play();
+    const GameState& state = match.current();
 
-    if (number_cubes_pl1 > number_cubes_pl2) {
-        who_win = who_win_mass[0];
-    }
-    if (number_cubes_pl1 < number_cubes_pl2) {
-        who_win = who_win_mass[1];
-    }
-    if (number_cubes_pl1 == number_cubes_pl2) {
-        who_win = who_win_mass[2];
+    cout << "pl1: " << state.pl1.cubes() << " | pl2: " << state.pl2.cubes() << " == " << who_win_mass[static_cast<int>(state.lastOutcome)] << "\n";
+    if (hasEvent(events, GameEvent::Pl1Fired | GameEvent::Pl2Fired)) {
+        cout << (hasEvent(events, GameEvent::Pl1Fired) ? pl1_name : pl2_name) << " shoots: " << (hasEvent(events, GameEvent::LiveRound) ? "live round" : "blank") << "\n";
     }
+    cout << "--------------------------------\n" << endl;
 
-    cout << "pl1: " << number_cubes_pl1 << " | pl2: " << number_cubes_pl2 << " == " << who_win << "\n--------------------------------\n" << endl;
+    return events;
 }
 
 
 int main() {
-    const float originalWidth = 1024.0f;
-    const float originalHeight = 512.0f;
+    AnimationSystem::initialize();
+
+    const float originalWidth = SceneLayout::originalWidth;
+    const float originalHeight = SceneLayout::originalHeight;
     
     RenderWindow window{VideoMode{ {static_cast<unsigned int>(originalWidth), static_cast<unsigned int>(originalHeight)} }, "Drop it or Die"};
     window.setFramerateLimit(60);
     Gui gui{window};
 
-    auto theme = tgui::Theme::create("./assets/themes/theme.txt");
-    auto font = "./assets/fonts/Hero-Bold.ttf";
+    // Пак ассетов (tools/pack_assets): одно отображение файла, картинки уже раскодированы; без пака - отдельные файлы
+    AssetPack pack;
+    pack.open("./assets.pak");
 
-    auto texture_hand_pl1 = tgui::Texture("./assets/textures/game/hands/hand_blue.png");
-    auto texture_hand_pl2 = tgui::Texture("./assets/textures/game/hands/hand_red.png");
-    auto glass_up = tgui::Texture("./assets/textures/game/cup/glass_up.png");
-    auto glass_down = tgui::Texture("./assets/textures/game/cup/glass_down.png");
+    // Спрайты из атласа (tools/pack_atlas) - одна GPU-текстура на все картинки; без атласа грузятся файлы по отдельности
+    TextureAtlas atlas;
+    if (const AssetView manifest = pack.view("textures/atlas/atlas.txt")) {
+        atlas.parse(reinterpret_cast<const char*>(manifest.data), manifest.size, "textures/atlas/");
+    } else {
+        atlas.load("./assets/textures/atlas/atlas.txt");
+    }
 
-    // Исходные позиции в пикселях от 1024x512
-    struct WidgetPosition {
-        float x, y, width, height;
+    // Картинки декодируются в фоне, окно рисуется сразу: до готовности у виджетов заглушка
+    AssetLoader assets;
+    assets.setPack(&pack);
+
+    // Текстуры, шрифты и темы по ID через общий кэш: грузятся при первом обращении, общие для всех виджетов
+    ResourceCache resources;
+    resources.setPack(&pack);
+    resources.setAtlas(&atlas);
+    resources.setLoader(&assets);
+
+    tgui::Font font = resources.font("fonts/Hero-Bold.ttf");
+    tgui::Texture glass_down;
+    tgui::UIntRect glass_down_part;
+
+    // Игровые фишки - слой спрайтов под GUI (sprite_batch.h): узлы двигают раскладка и анимации,
+    // рисуется всё одним массивом вершин; до загрузки у спрайтов заглушка
+    SpriteBatch sprites;
+    auto piece = [&](const char* textureId) {
+        tgui::Widget::Ptr node = SpriteBatch::createNode();
+        node->setOrigin(0.5, 0.5);
+        const SpriteBatch::Sprite sprite = sprites.add(node);
+        sprites.setImage(sprite, AssetLoader::placeholder());
+        resources.textureAsync(textureId, AssetPriority::Critical,
+                               [&sprites, sprite](const tgui::Texture& page, const tgui::UIntRect& part) {
+                                   if (part.width && part.height) sprites.setImage(sprite, page, part); // не загрузилось - остаётся заглушка
+                               });
+        return sprite;
     };
-
-    WidgetPosition positions[] = {
-        {558, 426, 150, 150},  // cup_pl1
-        {467, 86, 150, 150},   // cup_pl2
-        {372, 446, 100, 100},  // left_hand_pl1
-        {652, 451, 100, 100},  // right_hand_pl1
-        {652, 106, 100, 100},  // left_hand_pl2
-        {372, 109, 100, 100},  // right_hand_pl2
-        {512, 256, 150, 70}    // btn_tap
+    auto cup_pl1 = sprites.node(piece("textures/game/cup/glass_up.png"));
+    auto cup_pl2 = sprites.node(piece("textures/game/cup/glass_up.png"));
+    auto left_hand_pl1 = sprites.node(piece("textures/game/hands/hand_blue.png"));
+    auto right_hand_pl1 = sprites.node(piece("textures/game/hands/hand_blue.png"));
+    auto left_hand_pl2 = sprites.node(piece("textures/game/hands/hand_red.png"));
+    auto right_hand_pl2 = sprites.node(piece("textures/game/hands/hand_red.png"));
+    const SpriteBatch::Sprite revolver_sprite = piece("textures/game/pistol/revolver/revolver_up.png");
+    auto revolver = sprites.node(revolver_sprite);
+    auto muzzle_flash = sprites.node(piece("textures/game/pistol/fire_pistol.png"));
+    muzzle_flash->setVisible(false);
+
+    // Покадровые клипы (assets/animations/clips.txt): кадр - прямоугольник страницы атласа, смена кадра - только UV.
+    // Без атласа клипов нет - револьвер просто лежит
+    FrameAnimator frames(sprites);
+    std::vector<FrameClipSource> clip_sources;
+    if (const AssetView clips = pack.view("animations/clips.txt")) {
+        FrameClipSource::parse(reinterpret_cast<const char*>(clips.data), clips.size, clip_sources);
+    } else {
+        FrameClipSource::load("./assets/animations/clips.txt", clip_sources);
+    }
+    frames.setClips(clip_sources, atlas);
+
+    // Частицы выстрела (particle_system.h): искры у дула, гильза, при боевом патроне - кровь у того, в кого стреляли.
+    // Пулы фиксированного размера - ни выброс, ни кадр не аллоцируют; размеры - от узлов, чтобы следовать раскладке
+    ParticleSystem blood(2048), sparks(512), casings(32);
+    blood.setGravity(0, 600);
+    blood.setDrag(2);
+    sparks.setDrag(6);
+    sparks.setBlendMode(sf::BlendAdd);
+    casings.setGravity(0, 1200);
+    // Виды одной системы - с одной страницы атласа (pack_atlas кладёт папку гильз на одну страницу); чужой не рисуется
+    auto particle_kind = [&](ParticleSystem& system, const char* textureId) {
+        resources.textureAsync(textureId, AssetPriority::Decorative,
+                               [&system, textureId](const tgui::Texture& page, const tgui::UIntRect& part) {
+                                   if (!system.addKind(page, part)) std::fprintf(stderr, "particles: kind %s rejected\n", textureId);
+                               });
+    };
+    particle_kind(blood, "textures/game/blood/blood.png");
+    particle_kind(sparks, "textures/game/pistol/fire_pistol.png");
+    particle_kind(casings, "textures/game/pistol/patron/гильза_от_9х19.png");
+    particle_kind(casings, "textures/game/pistol/patron/гильза_от_9х19_под_наклоном(кривая).png");
+
+    auto shot_particles = [&](bool pl1_fired, bool live_round) {
+        FastRandom& rng = RandomSystem::local();
+        const float flash = muzzle_flash->getSize().x;
+
+        ParticleBurst spark;
+        spark.x = muzzle_flash->getPosition().x;
+        spark.y = muzzle_flash->getPosition().y;
+        spark.spread = 1.2f;
+        spark.speedMin = flash * 4;
+        spark.speedMax = flash * 12;
+        spark.lifeMin = 0.1f;
+        spark.lifeMax = 0.35f;
+        spark.sizeMin = flash * 0.04f;
+        spark.sizeMax = flash * 0.1f;
+        sparks.spawn(spark, 120, rng);
+
+        ParticleBurst casing;
+        casing.x = revolver->getPosition().x;
+        casing.y = revolver->getPosition().y;
+        casing.direction = -1.9f; // вверх и назад от дула
+        casing.spread = 0.5f;
+        casing.speedMin = flash * 6;
+        casing.speedMax = flash * 9;
+        casing.lifeMin = casing.lifeMax = 0.9f;
+        casing.sizeMin = casing.sizeMax = flash * 0.25f;
+        casing.spinMax = 14;
+        casings.spawn(casing, 1, rng);
+
+        if (!live_round) return;
+        const tgui::Widget::Ptr& target = pl1_fired ? cup_pl2 : cup_pl1;
+        const float cup = target->getSize().x;
+        ParticleBurst drop;
+        drop.x = target->getPosition().x;
+        drop.y = target->getPosition().y;
+        drop.speedMin = cup * 0.5f;
+        drop.speedMax = cup * 3;
+        drop.lifeMin = 0.4f;
+        drop.lifeMax = 1.2f;
+        drop.sizeMin = cup * 0.02f;
+        drop.sizeMax = cup * 0.06f;
+        drop.spinMax = 3;
+        blood.spawn(drop, 600, rng);
     };
 
+    // Раскладка стола - assets/layouts/table.txt (без файла - встроенная из scene_layout.h).
+    // Ресайз только запоминает размер окна, виджеты пересчитываются один раз за кадр перед отрисовкой
+    LayoutSystem layout;
+    if (const AssetView table = pack.view("layouts/table.txt")) {
+        layout.parse(reinterpret_cast<const char*>(table.data), table.size);
+    } else if (!layout.load("./assets/layouts/table.txt")) {
+        layout.loadDefaults();
+    }
 
-    // Widgets
-    auto cup_pl1 = tgui::Picture::create(glass_up); gui.add(cup_pl1);
-    cup_pl1->setOrigin(0.5, 0.5);
-
-    auto cup_pl2 = tgui::Picture::create(glass_up); gui.add(cup_pl2);
-    cup_pl2->setOrigin(0.5, 0.5);
-
-    auto left_hand_pl1 = tgui::Picture::create(texture_hand_pl1); gui.add(left_hand_pl1);
-    left_hand_pl1->setOrigin(0.5, 0.5);
-
-    auto right_hand_pl1 = tgui::Picture::create(texture_hand_pl1); gui.add(right_hand_pl1);
-    right_hand_pl1->setOrigin(0.5, 0.5);
-
-    auto left_hand_pl2 = tgui::Picture::create(texture_hand_pl2); gui.add(left_hand_pl2);
-    left_hand_pl2->setOrigin(0.5, 0.5);
+    // Кубики (dice_physics.h): каждый раунд высыпаются из стаканов и ложатся гранями, которые выбросил GameCore.
+    // Мир - в пикселях исходной сцены, узлы спрайтов ставятся через преобразование раскладки
+    DicePhysics dice;
+    const DiceTable dice_table{ 260, 40, 764, 472 }; // между руками игроков
+    tgui::Texture dice_faces[7];
+    tgui::UIntRect dice_face_parts[7];
+    for (int face = 1; face <= 6; ++face) {
+        resources.textureAsync("textures/game/dice/dice" + std::to_string(face) + ".png", AssetPriority::Decorative,
+                               [&dice_faces, &dice_face_parts, face](const tgui::Texture& page, const tgui::UIntRect& part) {
+                                   dice_faces[face] = page;
+                                   dice_face_parts[face] = part;
+                               });
+    }
+    SpriteBatch::Sprite dice_sprites[4];
+    uint8_t dice_shown[4] = {};
+    for (SpriteBatch::Sprite& sprite : dice_sprites) {
+        tgui::Widget::Ptr node = SpriteBatch::createNode();
+        node->setOrigin(0.5, 0.5);
+        node->setVisible(false);
+        sprite = sprites.add(node);
+    }
 
-    auto right_hand_pl2 = tgui::Picture::create(texture_hand_pl2); gui.add(right_hand_pl2);
-    right_hand_pl2->setOrigin(0.5, 0.5);
+    auto throw_dice = [&](const GameState& state) {
+        const LayoutTransform& t = layout.transform();
+        if (t.scale <= 0) return;
+        FastRandom rng(RandomSystem::local().nextU64());
+        dice.reset(dice_table);
+
+        DiceThrow from_pl1;
+        from_pl1.x = (cup_pl1->getPosition().x - t.offsetX) / t.scale;
+        from_pl1.y = (cup_pl1->getPosition().y - t.offsetY) / t.scale;
+        from_pl1.direction = -1.5708f;
+        dice.throwDice(from_pl1, 2, rng);
+
+        DiceThrow from_pl2;
+        from_pl2.x = (cup_pl2->getPosition().x - t.offsetX) / t.scale;
+        from_pl2.y = (cup_pl2->getPosition().y - t.offsetY) / t.scale;
+        from_pl2.direction = 1.5708f;
+        dice.throwDice(from_pl2, 2, rng);
+
+        const uint8_t wanted[4] = { static_cast<uint8_t>(state.pl1.cube1), static_cast<uint8_t>(state.pl1.cube2),
+                                    static_cast<uint8_t>(state.pl2.cube1), static_cast<uint8_t>(state.pl2.cube2) };
+        dice.steer(wanted, 4);
+        for (size_t i = 0; i < 4; ++i) {
+            sprites.node(dice_sprites[i])->setVisible(true);
+            dice_shown[i] = 0;
+        }
+    };
 
     // pl1 score
     auto score_pl1_text = tgui::Label::create(); gui.add(score_pl1_text);
-    string full_text_pl1_score = "(" + pl1_name + ") score: " + to_string(score_pl1_short);
-    score_pl1_text->setText(full_text_pl1_score);
+    score_pl1_text->setText(score_text(full_text_1, pl1_name, 0));
 
     score_pl1_text->getRenderer()->setTextColor(tgui::Color::White);
     score_pl1_text->getRenderer()->setFont(font);
@@ -165,8 +291,7 @@ int main() {
 
     // pl2 score
     auto score_pl2_text = tgui::Label::create("Score: 0"); gui.add(score_pl2_text);
-    string full_text_pl2_score = "(" + pl2_name + ") score: " + to_string(score_pl2_short);
-    score_pl2_text->setText(full_text_pl2_score);
+    score_pl2_text->setText(score_text(full_text_2, pl2_name, 0));
 
     score_pl2_text->getRenderer()->setTextColor(tgui::Color::White); 
     score_pl2_text->getRenderer()->setFont(font);
@@ -176,83 +301,190 @@ int main() {
 
     // center button
     auto btn_tap = Button::create("Click me!"); gui.add(btn_tap);
-    btn_tap->setRenderer(theme->getRenderer("gd_button"));
     btn_tap->setTextSize(28);
     btn_tap->setOrigin(0.5, 0.5);
+
+    // Фишки и тема кнопки - раньше декоративного; тема разбирается в главном потоке после первого кадра
+    resources.textureAsync("textures/game/cup/glass_down.png", AssetPriority::Decorative,
+                           [&glass_down, &glass_down_part](const tgui::Texture& page, const tgui::UIntRect& part) {
+                               glass_down = page;
+                               glass_down_part = part;
+                           });
+    assets.defer(AssetPriority::Critical, [&resources, btn_tap] {
+        btn_tap->setRenderer(resources.renderer("themes/theme.txt", "gd_button"));
+    });
     
     btn_tap->onPress([&]{
+        ALLOC_SCOPE("onPress");
+        GameEvent events = play();
+        const GameState& state = match.current();
         
-        play();
-        
-        if (number_cubes_pl1 > number_cubes_pl2) {
-            score_pl1_short++;
-            full_text_1 = "(" + pl1_name + ") score: " + to_string(score_pl1_short);
-            score_pl1_text->setText(full_text_1);
+        // Кубики раунда ложатся гранями, выпавшими в GameCore
+        throw_dice(state);
+
+        // Новый матч обнуляет оба счёта, иначе обновляется только счёт победителя раунда
+        if (hasEvent(events, GameEvent::Pl1WonRound) || state.round == 1) {
+            score_pl1_text->setText(score_text(full_text_1, pl1_name, state.pl1.score));
         }
-        if (number_cubes_pl1 < number_cubes_pl2) {
-            score_pl2_short++;
-            full_text_2 = "(" + pl2_name + ") score: " + to_string(score_pl2_short);
-            score_pl2_text->setText(full_text_2);
+        if (hasEvent(events, GameEvent::Pl2WonRound) || state.round == 1) {
+            score_pl2_text->setText(score_text(full_text_2, pl2_name, state.pl2.score));
         }
-    });
 
-    auto updateWidgetsLayout = [&]() {
-        float currentWidth = gui.getView().getWidth();
-        float currentHeight = gui.getView().getHeight();
-        
-        float scaleX = currentWidth / originalWidth;
-        float scaleY = currentHeight / originalHeight;
-        float scale = std::min(scaleX, scaleY);
-        
-        float offsetX = (currentWidth - (originalWidth * scale)) / 2.0f;
-        float offsetY = (currentHeight - (originalHeight * scale)) / 2.0f;
-        
-        cup_pl1->setSize(positions[0].width * scale, positions[0].height * scale);
-        cup_pl1->setPosition(offsetX + (positions[0].x * scale), offsetY + (positions[0].y * scale));
-        
-        cup_pl2->setSize(positions[1].width * scale, positions[1].height * scale);
-        cup_pl2->setPosition(offsetX + (positions[1].x * scale), offsetY + (positions[1].y * scale));
-        
-        left_hand_pl1->setSize(positions[2].width * scale, positions[2].height * scale);
-        left_hand_pl1->setPosition(offsetX + (positions[2].x * scale), offsetY + (positions[2].y * scale));
-        
-        right_hand_pl1->setSize(positions[3].width * scale, positions[3].height * scale);
-        right_hand_pl1->setPosition(offsetX + (positions[3].x * scale), offsetY + (positions[3].y * scale));
-        
-        left_hand_pl2->setSize(positions[4].width * scale, positions[4].height * scale);
-        left_hand_pl2->setPosition(offsetX + (positions[4].x * scale), offsetY + (positions[4].y * scale));
-        
-        right_hand_pl2->setSize(positions[5].width * scale, positions[5].height * scale);
-        right_hand_pl2->setPosition(offsetX + (positions[5].x * scale), offsetY + (positions[5].y * scale));
-        
-        btn_tap->setSize(positions[6].width * scale, positions[6].height * scale);
-        btn_tap->setPosition(offsetX + (positions[6].x * scale), offsetY + (positions[6].y * scale));
-        
-        unsigned int textSize = static_cast<unsigned int>(16 * scale);
-        score_pl1_text->setTextSize(textSize);
-        score_pl2_text->setTextSize(textSize);
-        btn_tap->setTextSize(static_cast<unsigned int>(28 * scale));
-    };
+        // Выстрел: клип револьвера, на кадре "fire" - вспышка на 0.1 с и частицы
+        if (hasEvent(events, GameEvent::Pl1Fired | GameEvent::Pl2Fired)) {
+            const bool pl1_fired = hasEvent(events, GameEvent::Pl1Fired);
+            const bool live_round = hasEvent(events, GameEvent::LiveRound);
+            frames.play(revolver_sprite, "revolver_shot", [muzzle_flash, &shot_particles, pl1_fired, live_round](const std::string& event) {
+                if (event != "fire") return;
+                shot_particles(pl1_fired, live_round);
+                muzzle_flash->setVisible(true);
+                timer(0.1, [muzzle_flash] { muzzle_flash->setVisible(false); });
+            });
+        }
+        RenderScheduler::invalidate();
+    });
 
-    updateWidgetsLayout();
+    layout.bind("cup_pl1", cup_pl1);
+    layout.bind("cup_pl2", cup_pl2);
+    layout.bind("left_hand_pl1", left_hand_pl1);
+    layout.bind("right_hand_pl1", right_hand_pl1);
+    layout.bind("left_hand_pl2", left_hand_pl2);
+    layout.bind("right_hand_pl2", right_hand_pl2);
+    layout.bind("revolver", revolver);
+    layout.bind("muzzle_flash", muzzle_flash);
+    layout.bind("btn_tap", btn_tap);
+    layout.bind("score_pl1", score_pl1_text);
+    layout.bind("score_pl2", score_pl2_text);
+    layout.resize(gui.getView().getWidth(), gui.getView().getHeight());
+    layout.update();
 
     gui.onViewChange([&]{
-        updateWidgetsLayout();
+        layout.resize(gui.getView().getWidth(), gui.getView().getHeight());
     });
     
+    // F3 - оверлей профайлера, F4 - трасса последних кадров в trace.json (chrome://tracing)
+    ProfilerOverlay profiler_overlay(gui, {"idle", "events", "assets", "timers", "frames", "particles", "dice", "layout", "sprites", "draw", "display"});
+
+    double step_time = 0;
+
+    auto handleEvent = [&](const sf::Event& event) {
+        gui.handleEvent(event);
+        RenderScheduler::invalidate(); // наведение, нажатие, ресайз - виджеты могли измениться
+
+        if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+            if (key->code == sf::Keyboard::Key::F3)
+                profiler_overlay.toggle();
+            else if (key->code == sf::Keyboard::Key::F4)
+                Profiler::writeChromeTrace("trace.json");
+        }
+
+        // quit - close window
+        if (event.is<sf::Event::Closed>()) {
+            resources.printReport();
+            AnimationSystem::shutdown();
+            window.close();
+        }
+    };
+
     while (window.isOpen())
     {
-        while (const std::optional event = window.pollEvent()) {
-            gui.handleEvent(*event);
-            
-            // quit - close window
-            if (event->is<sf::Event::Closed>())
-                window.close();
+        PROFILE_FRAME_BEGIN();
+        ALLOC_SCOPE("frame");
+
+        // Перерисовывать нечего - спим до события: кадр, пока что-то идёт само, иначе до ближайшего таймера
+        {
+            PROFILE_SCOPE("idle");
+            if (profiler_overlay.isVisible()) RenderScheduler::invalidate(); // график обновляется каждый кадр
+            const double sleep = RenderScheduler::sleepSeconds(!assets.idle() || frames.busy() ||
+                blood.busy() || sparks.busy() || casings.busy() || dice.busy(),
+                AnimationSystem::untilNextTimer());
+            if (sleep > 0) {
+                if (const std::optional event = window.waitEvent(sf::seconds(static_cast<float>(sleep))))
+                    handleEvent(*event);
+            }
+        }
+
+        {
+            PROFILE_SCOPE("events");
+            while (const std::optional event = window.pollEvent())
+                handleEvent(*event);
+        }
+
+        {
+            PROFILE_SCOPE("assets");
+            if (assets.pump(0.002)) RenderScheduler::invalidate(); // загрузка в видеопамять - не больше ~2 мс за кадр
+        }
+
+        {
+            PROFILE_SCOPE("timers");
+            if (AnimationSystem::updateAnimations()) RenderScheduler::invalidate();
+        }
+
+        {
+            PROFILE_SCOPE("frames");
+            frames.update(AnimationSystem::time());
+        }
+
+        // Шаг частиц и кубиков - время с прошлого кадра; после долгого сна - без рывка
+        const double step_now = AnimationSystem::time();
+        const float dt = static_cast<float>(std::min(step_now - step_time, 0.1));
+        step_time = step_now;
+
+        {
+            PROFILE_SCOPE("particles");
+            bool moved = blood.update(dt);
+            moved |= casings.update(dt);
+            moved |= sparks.update(dt);
+            if (moved) RenderScheduler::invalidate();
+        }
+
+        {
+            PROFILE_SCOPE("dice");
+            if (dice.busy()) dice.advance(dt);
+            // Ставится каждый кадр - следует и за ресайзом; SpriteBatch::sync() заметит, только если что-то сдвинулось
+            const LayoutTransform& t = layout.transform();
+            for (size_t i = 0; i < dice.size(); ++i) {
+                const tgui::Widget::Ptr& node = sprites.node(dice_sprites[i]);
+                node->setSize(2 * dice.radius * t.scale, 2 * dice.radius * t.scale);
+                node->setPosition(t.offsetX + dice.x(i) * t.scale, t.offsetY + dice.y(i) * t.scale);
+                node->setRotation(dice.angle(i) * 180 / 3.14159265f);
+                const uint8_t face = dice.face(i);
+                if (face != dice_shown[i] && dice_faces[face].getData()) {
+                    sprites.setImage(dice_sprites[i], dice_faces[face], dice_face_parts[face]);
+                    dice_shown[i] = face;
+                }
+            }
+        }
+
+        {
+            PROFILE_SCOPE("layout");
+            if (layout.update()) RenderScheduler::invalidate();
+        }
+
+        {
+            PROFILE_SCOPE("sprites");
+            if (sprites.sync()) RenderScheduler::invalidate(); // трансформы всех фишек разом - после анимаций и раскладки
+        }
+
+        // render - только если кадр испорчен, иначе на экране остаётся прошлый
+        if (RenderScheduler::beginFrame()) {
+            {
+                PROFILE_SCOPE("draw");
+                profiler_overlay.update();
+                window.clear({62, 35, 0});
+                sprites.draw(window, gui.getView().getRect());
+                blood.draw(window, gui.getView().getRect());
+                casings.draw(window, gui.getView().getRect());
+                sparks.draw(window, gui.getView().getRect());
+                gui.draw();
+            }
+
+            {
+                PROFILE_SCOPE("display");
+                window.display();
+            }
         }
 
-        // render
-        window.clear({62, 35, 0});
-        gui.draw();
-        window.display();
+        PROFILE_FRAME_END();
     }
 }
\ No newline at end of file
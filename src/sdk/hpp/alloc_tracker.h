@@ -0,0 +1,281 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Учёт кучи: глобальные operator new/delete подменяются, если ALLOC_TRACKER_HOOK определён
+// ровно в одной единице трансляции (main.cpp/main_ds_anim.cpp собираются одним .cpp - хватает -DALLOC_TRACKER_HOOK).
+// ALLOC_SCOPE("tag") считает аллокации, байты и пик живых байт своего потока за время области;
+// бюджет тега - максимум аллокаций на одну область, строгий режим падает при превышении.
+
+// Счётчики одного потока; пик - максимум живых байт с начала текущей области
+struct AllocCounters {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;
+    int64_t live;
+    int64_t peak;
+};
+
+// Итоги по тегу; last* - последняя завершённая область (кадр, раунд), max* - худшая
+struct AllocTagStats {
+    const char* tag = nullptr;
+    uint64_t scopes = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t lastAllocations = 0;
+    uint64_t lastBytes = 0;
+    int64_t lastPeak = 0;
+    uint64_t maxAllocations = 0;
+    int64_t maxPeak = 0;
+    uint64_t budget = UINT64_MAX; // аллокаций на область
+    uint64_t overBudget = 0;
+};
+
+class AllocTracker {
+public:
+    static constexpr size_t maxTags = 64;
+
+    // Вызываются из подменённых new/delete; ничего не аллоцируют
+    static void onAllocate(size_t size) {
+        AllocCounters& c = thread();
+        ++c.allocations;
+        c.bytes += size;
+        c.live += static_cast<int64_t>(size);
+        c.peak = std::max(c.peak, c.live);
+        totalAllocs.fetch_add(1, std::memory_order_relaxed);
+        totalBytes.fetch_add(size, std::memory_order_relaxed);
+        liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    }
+
+    static void onFree(size_t size) {
+        AllocCounters& c = thread();
+        ++c.frees;
+        c.live -= static_cast<int64_t>(size); // может уйти в минус: освобождаем память другого потока
+        totalFrees.fetch_add(1, std::memory_order_relaxed);
+        liveBytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+    }
+
+    static AllocCounters& thread() {
+        thread_local AllocCounters counters{};
+        return counters;
+    }
+
+    // Перехват установлен и что-то уже посчитал
+    static bool hooked() { return totalAllocs.load(std::memory_order_relaxed) > 0; }
+
+    static uint64_t totalAllocations() { return totalAllocs.load(std::memory_order_relaxed); }
+    static uint64_t totalAllocatedBytes() { return totalBytes.load(std::memory_order_relaxed); }
+    static uint64_t totalFreed() { return totalFrees.load(std::memory_order_relaxed); }
+    static int64_t liveAllocatedBytes() { return liveBytes.load(std::memory_order_relaxed); }
+
+    // Бюджет: не больше allocations аллокаций за одну область тега (0 - горячий путь без кучи)
+    static void setBudget(const char* tag, uint64_t allocations) {
+        std::lock_guard<std::mutex> lock(tagMutex);
+        if (AllocTagStats* stats = find(tag)) stats->budget = allocations;
+    }
+
+    // Строгий (тестовый) режим: превышение бюджета печатается и роняет процесс
+    static void setStrict(bool on) { strict.store(on, std::memory_order_relaxed); }
+
+    static uint64_t overBudgetCount() { return overBudgetTotal.load(std::memory_order_relaxed); }
+
+    // Итоги области: зовёт AllocScope
+    static void report(const char* tag, uint64_t allocations, uint64_t bytes, int64_t peak) {
+        uint64_t budget;
+        {
+            std::lock_guard<std::mutex> lock(tagMutex);
+            AllocTagStats* stats = find(tag);
+            if (!stats) return;
+            ++stats->scopes;
+            stats->allocations += allocations;
+            stats->bytes += bytes;
+            stats->lastAllocations = allocations;
+            stats->lastBytes = bytes;
+            stats->lastPeak = peak;
+            stats->maxAllocations = std::max(stats->maxAllocations, allocations);
+            stats->maxPeak = std::max(stats->maxPeak, peak);
+            budget = stats->budget;
+            if (allocations > budget) ++stats->overBudget;
+        }
+
+        if (allocations > budget) {
+            overBudgetTotal.fetch_add(1, std::memory_order_relaxed);
+            if (strict.load(std::memory_order_relaxed)) {
+                std::fprintf(stderr, "alloc budget exceeded: %s made %llu allocations (budget %llu)\n", tag,
+                             (unsigned long long)allocations, (unsigned long long)budget);
+                std::abort();
+            }
+        }
+    }
+
+    // Копия итогов по всем тегам (для оверлея и отчётов; аллоцирует - не из горячего пути)
+    static void tags(std::vector<AllocTagStats>& out) {
+        std::lock_guard<std::mutex> lock(tagMutex);
+        out.assign(tagStats, tagStats + tagCount);
+    }
+
+    static void print(FILE* out = stdout) {
+        std::lock_guard<std::mutex> lock(tagMutex);
+        std::fprintf(out, "%-16s %10s %12s %12s %10s %10s %8s\n", "tag", "scopes", "allocs/scope", "bytes/scope", "max", "peak", "over");
+        for (size_t i = 0; i < tagCount; ++i) {
+            const AllocTagStats& s = tagStats[i];
+            const double scopes = s.scopes ? static_cast<double>(s.scopes) : 1.0;
+            std::fprintf(out, "%-16s %10llu %12.2f %12.1f %10llu %10lld %8llu\n", s.tag, (unsigned long long)s.scopes,
+                         s.allocations / scopes, s.bytes / scopes, (unsigned long long)s.maxAllocations,
+                         (long long)s.maxPeak, (unsigned long long)s.overBudget);
+        }
+    }
+
+private:
+    // Тег ищется по содержимому строки; новая запись заводится при первом обращении
+    static AllocTagStats* find(const char* tag) {
+        for (size_t i = 0; i < tagCount; ++i) {
+            if (tagStats[i].tag == tag || std::strcmp(tagStats[i].tag, tag) == 0) return &tagStats[i];
+        }
+        if (tagCount == maxTags) return nullptr;
+        tagStats[tagCount].tag = tag;
+        return &tagStats[tagCount++];
+    }
+
+    static std::atomic<uint64_t> totalAllocs;
+    static std::atomic<uint64_t> totalFrees;
+    static std::atomic<uint64_t> totalBytes;
+    static std::atomic<int64_t> liveBytes;
+    static std::atomic<uint64_t> overBudgetTotal;
+    static std::atomic<bool> strict;
+    static std::mutex tagMutex;
+    static AllocTagStats tagStats[maxTags];
+    static size_t tagCount;
+};
+
+// Аллокации текущего потока за время жизни объекта; вложенные области не портят пик внешней
+class AllocScope {
+public:
+    explicit AllocScope(const char* scopeTag) : tag(scopeTag), start(AllocTracker::thread()) {
+        AllocTracker::thread().peak = start.live;
+    }
+
+    ~AllocScope() {
+        AllocCounters& now = AllocTracker::thread();
+        AllocTracker::report(tag, now.allocations - start.allocations, now.bytes - start.bytes, now.peak - start.live);
+        now.peak = std::max(now.peak, start.peak);
+    }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    const char* tag;
+    AllocCounters start;
+};
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+#ifdef ALLOC_TRACKER_HOOK
+#define ALLOC_SCOPE(tag) AllocScope ALLOC_CONCAT(allocScope, __LINE__)(tag)
+#else
+#define ALLOC_SCOPE(tag)
+#endif
+
+std::atomic<uint64_t> AllocTracker::totalAllocs{0};
+std::atomic<uint64_t> AllocTracker::totalFrees{0};
+std::atomic<uint64_t> AllocTracker::totalBytes{0};
+std::atomic<int64_t> AllocTracker::liveBytes{0};
+std::atomic<uint64_t> AllocTracker::overBudgetTotal{0};
+std::atomic<bool> AllocTracker::strict{false};
+std::mutex AllocTracker::tagMutex;
+AllocTagStats AllocTracker::tagStats[AllocTracker::maxTags];
+size_t AllocTracker::tagCount = 0;
+
+#ifdef ALLOC_TRACKER_HOOK
+// Размер блока хранится в заголовке перед ним: 16 байт сохраняют выравнивание malloc.
+// Сверхвыровненные типы (alignas(32) DiceBatch, alignas(64) очереди) идут через align_val_t-перегрузки -
+// те же счётчики, в заголовке ещё и начало блока для free
+namespace AllocTrackerHook {
+    constexpr size_t header = 16;
+
+    inline void* allocate(std::size_t size) {
+        char* block = static_cast<char*>(std::malloc(size + header));
+        if (!block) return nullptr;
+        std::memcpy(block, &size, sizeof(size));
+        AllocTracker::onAllocate(size);
+        return block + header;
+    }
+
+    inline void release(void* p) {
+        if (!p) return;
+        char* block = static_cast<char*>(p) - header;
+        std::size_t size;
+        std::memcpy(&size, block, sizeof(size));
+        AllocTracker::onFree(size);
+        std::free(block);
+    }
+
+    inline void* allocateAligned(std::size_t size, std::size_t alignment) {
+        alignment = std::max(alignment, header);
+        char* block = static_cast<char*>(std::malloc(size + header + alignment - 1));
+        if (!block) return nullptr;
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block) + header;
+        char* p = reinterpret_cast<char*>((start + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+        std::memcpy(p - header, &size, sizeof(size));
+        std::memcpy(p - header + sizeof(size), &block, sizeof(block));
+        AllocTracker::onAllocate(size);
+        return p;
+    }
+
+    inline void releaseAligned(void* p) {
+        if (!p) return;
+        const char* head = static_cast<char*>(p) - header;
+        std::size_t size;
+        char* block;
+        std::memcpy(&size, head, sizeof(size));
+        std::memcpy(&block, head + sizeof(size), sizeof(block));
+        AllocTracker::onFree(size);
+        std::free(block);
+    }
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = AllocTrackerHook::allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return AllocTrackerHook::allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return AllocTrackerHook::allocate(size); }
+void operator delete(void* p) noexcept { AllocTrackerHook::release(p); }
+void operator delete[](void* p) noexcept { AllocTrackerHook::release(p); }
+void operator delete(void* p, std::size_t) noexcept { AllocTrackerHook::release(p); }
+void operator delete[](void* p, std::size_t) noexcept { AllocTrackerHook::release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { AllocTrackerHook::release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { AllocTrackerHook::release(p); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = AllocTrackerHook::allocateAligned(size, static_cast<std::size_t>(alignment))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocTrackerHook::allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocTrackerHook::allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p, std::align_val_t) noexcept { AllocTrackerHook::releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AllocTrackerHook::releaseAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { AllocTrackerHook::releaseAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { AllocTrackerHook::releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { AllocTrackerHook::releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { AllocTrackerHook::releaseAligned(p); }
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef ANIMATION_CLOCK_H
+#define ANIMATION_CLOCK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "inline_function.h"
+
+enum class ClockMode : uint8_t {
+    RealTime,  // время = источник, один шаг на кадр
+    FixedStep, // время идёт ровными шагами, реальное время копится в аккумуляторе
+    Manual     // время двигает только advance() - для тестов и headless-прогонов
+};
+
+// Часы анимаций. Источник времени подменяется (по умолчанию steady_clock от reset()).
+class AnimationClock {
+public:
+    using TimeSource = InlineFunction<double()>;
+
+    explicit AnimationClock(ClockMode clockMode = ClockMode::RealTime, double fixedStep = 1.0 / 60) {
+        setMode(clockMode, fixedStep);
+        reset();
+    }
+
+    void setMode(ClockMode clockMode, double fixedStep = 1.0 / 60) {
+        mode = clockMode;
+        step = fixedStep > 0 ? fixedStep : 1.0 / 60;
+        accumulator = 0;
+        lastSource = source();
+    }
+
+    // Свой источник секунд (например, время кадра движка); nullptr - снова steady_clock
+    void setSource(TimeSource timeSource) {
+        customSource = std::move(timeSource);
+        lastSource = source();
+    }
+
+    // Не больше стольких фиксированных шагов за кадр - после долгой паузы не догоняем бесконечно
+    void setMaxSteps(int steps) { maxSteps = std::max(1, steps); }
+
+    void reset() {
+        epoch = std::chrono::steady_clock::now();
+        time = 0;
+        accumulator = 0;
+        lastSource = source();
+    }
+
+    ClockMode currentMode() const { return mode; }
+    double fixedStep() const { return step; }
+
+    // Текущее время анимаций в секундах
+    double now() const { return time; }
+
+    // Доля шага, оставшаяся в аккумуляторе (для интерполяции отрисовки в FixedStep)
+    double alpha() const { return mode == ClockMode::FixedStep ? accumulator / step : 0.0; }
+
+    // Начало кадра: сколько шагов обновления сделать. Время продвигает nextStep().
+    int frameSteps() {
+        if (mode == ClockMode::Manual) return 1;
+
+        const double sourceNow = source();
+        const double delta = std::max(sourceNow - lastSource, 0.0);
+        lastSource = sourceNow;
+
+        if (mode == ClockMode::RealTime) {
+            pending = delta;
+            return 1;
+        }
+
+        accumulator += delta;
+        int steps = static_cast<int>(accumulator / step);
+        if (steps > maxSteps) {
+            steps = maxSteps;
+            accumulator = 0; // отставание сбрасывается, а не копится
+        } else {
+            accumulator -= steps * step;
+        }
+        return steps;
+    }
+
+    // Время следующего шага кадра
+    double nextStep() {
+        if (mode == ClockMode::RealTime) {
+            time += pending;
+            pending = 0;
+        } else if (mode == ClockMode::FixedStep) {
+            time += step;
+        }
+        return time;
+    }
+
+    // Ручной режим: сдвинуть время
+    void advance(double seconds) {
+        time += std::max(seconds, 0.0);
+    }
+
+private:
+    double source() const {
+        if (customSource) return customSource();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    ClockMode mode = ClockMode::RealTime;
+    double step = 1.0 / 60;
+    int maxSteps = 8;
+    double time = 0;
+    double pending = 0;
+    double accumulator = 0;
+    double lastSource = 0;
+    std::chrono::steady_clock::time_point epoch;
+    TimeSource customSource;
+};
+
+#endif
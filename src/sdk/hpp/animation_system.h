@@ -8,8 +8,15 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
-#include <mutex>
 #include <cmath>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "inline_function.h"
+#include "animation_clock.h"
+#include "timer_wheel.h"
+#include "command_queue.h"
 
 // Типы easing-функций
 enum class EasingType {
@@ -34,11 +41,13 @@ namespace EasingFunctions {
     static float easeOut(float t) { return 1 - (1 - t) * (1 - t); }
     
     static float easeInOut(float t) { 
-        return t < 0.5 ? 2 * t * t : 1 - std::pow(-2 * t + 2, 2) / 2; 
+        return t < 0.5 ? 2 * t * t : 1 - (-2 * t + 2) * (-2 * t + 2) / 2; 
     }
     
+    static float bounceOut(float t);
+    
     static float bounceIn(float t) {
-        return 1 - bounceIn(1 - t);
+        return 1 - bounceOut(1 - t);
     }
     
     static float bounceOut(float t) {
@@ -56,16 +65,25 @@ namespace EasingFunctions {
         }
     }
     
+    // Сама кривая без точных 0 и 1 на концах - по ней строится таблица
+    static float elasticInCurve(float t) {
+        return -std::pow(2, 10 * t - 10) * std::sin((t * 10 - 10.75f) * (2 * M_PI) / 3);
+    }
+    
+    static float elasticOutCurve(float t) {
+        return std::pow(2, -10 * t) * std::sin((t * 10 - 0.75f) * (2 * M_PI) / 3) + 1;
+    }
+    
     static float elasticIn(float t) {
         if (t <= 0) return 0;
         if (t >= 1) return 1;
-        return -std::pow(2, 10 * t - 10) * std::sin((t * 10 - 10.75f) * (2 * M_PI) / 3);
+        return elasticInCurve(t);
     }
     
     static float elasticOut(float t) {
         if (t <= 0) return 0;
         if (t >= 1) return 1;
-        return std::pow(2, -10 * t) * std::sin((t * 10 - 0.75f) * (2 * M_PI) / 3) + 1;
+        return elasticOutCurve(t);
     }
     
     static float backIn(float t) {
@@ -77,7 +95,7 @@ namespace EasingFunctions {
     static float backOut(float t) {
         const float c1 = 1.70158f;
         const float c3 = c1 + 1;
-        return 1 + c3 * std::pow(t - 1, 3) + c1 * std::pow(t - 1, 2);
+        return 1 + c3 * (t - 1) * (t - 1) * (t - 1) + c1 * (t - 1) * (t - 1);
     }
     
     static float applyEasing(EasingType type, float t) {
@@ -97,290 +115,895 @@ namespace EasingFunctions {
     }
 }
 
-struct AnimationStep {
+// Таблицы для дорогих кривых (elastic: pow + sin) с линейной интерполяцией.
+// Ошибка ограничена выводом, а не замером: у линейной интерполяции с шагом h на интервале
+// |табличное - кривая| <= h^2/8 * max|f''|. Для elastic f = 2^(+-10t + c) * sin(w*t + phi), множитель 2^(...)
+// на [0, 1] не больше 1, поэтому |f''| <= k^2 + w^2, k = 10*ln2, w = 20*pi/3 (~487).
+// Сверху - запас на float: аргументы pow и sin считаются во float (t*10 - 10.75f - до ulp(10) на узле и в эталоне),
+// значения до ~1.4 округляются при записи и интерполяции. Граница проверяется при компиляции.
+class EasingTables {
+public:
+    static constexpr size_t resolution = 2048;
+    static constexpr float errorBound = 1e-4f;
+
+    static constexpr double elasticCurvature = (10 * 0.6931471805599453) * (10 * 0.6931471805599453) +
+                                               (20 * 3.141592653589793 / 3) * (20 * 3.141592653589793 / 3);
+    static constexpr double roundingSlack = 1e-5;
+    static constexpr double elasticBound = elasticCurvature / (8.0 * resolution * resolution) + roundingSlack;
+    static_assert(elasticBound <= errorBound, "elastic table: resolution too low for errorBound");
+
+    static bool enabled;
+
+    struct Table {
+        float values[resolution + 2];
+        float bound;    // выведенная граница ошибки
+        float maxError; // замер в 16 точках на интервал - для отчёта, должен быть не больше bound
+    };
+
+    static bool usable(EasingType type) {
+        const Table* t = find(type);
+        return enabled && t && t->bound <= errorBound;
+    }
+
+    static float bound(EasingType type) {
+        const Table* t = find(type);
+        return t ? t->bound : 0.0f;
+    }
+
+    static float maxError(EasingType type) {
+        const Table* t = find(type);
+        return t ? t->maxError : 0.0f;
+    }
+
+    // Таблица кривой (nullptr - у кривой таблицы нет); пакету - один раз, а не на каждый элемент
+    static const Table* find(EasingType type) {
+        static const Table elasticIn = build(EasingFunctions::elasticInCurve, EasingFunctions::elasticIn, elasticBound);
+        static const Table elasticOut = build(EasingFunctions::elasticOutCurve, EasingFunctions::elasticOut, elasticBound);
+        switch (type) {
+            case EasingType::ElasticIn: return &elasticIn;
+            case EasingType::ElasticOut: return &elasticOut;
+            default: return nullptr;
+        }
+    }
+
+    // Концы как у эталона: ровно 0 и 1
+    static float sample(const Table& table, float t) {
+        const float value = interpolate(table, t);
+        return t <= 0 ? 0.0f : t >= 1 ? 1.0f : value;
+    }
+
+    static float sample(EasingType type, float t) {
+        return sample(*find(type), t);
+    }
+
+private:
+    static float interpolate(const Table& table, float t) {
+        const float x = std::min(std::max(t, 0.0f), 1.0f) * resolution;
+        const size_t i = static_cast<size_t>(x);
+        const float f = x - static_cast<float>(i);
+        return table.values[i] + (table.values[i + 1] - table.values[i]) * f;
+    }
+
+    static Table build(float (*curve)(float), float (*reference)(float), double bound) {
+        Table table;
+        table.bound = static_cast<float>(bound);
+        for (size_t i = 0; i <= resolution; ++i) {
+            table.values[i] = curve(static_cast<float>(i) / resolution);
+        }
+        table.values[resolution + 1] = table.values[resolution];
+
+        table.maxError = 0;
+        const int probes = 16;
+        for (size_t i = 0; i < resolution; ++i) {
+            for (int p = 1; p < probes; ++p) {
+                const float t = (static_cast<float>(i) + static_cast<float>(p) / probes) / resolution;
+                table.maxError = std::max(table.maxError, std::fabs(interpolate(table, t) - reference(t)));
+            }
+        }
+        return table;
+    }
+};
+
+// Пакетная версия: кривая выбирается при компиляции, циклы без ветвлений по типу
+namespace EasingFunctions {
+    constexpr size_t typeCount = static_cast<size_t>(EasingType::BackOut) + 1;
+
+    // bounceOut через выбор, а не ветвление - векторизуется
+    inline float bounceOutSelect(float t) {
+        const float a = 7.5625f * t * t;
+        const float u1 = t - 1.5f / 2.75f;
+        const float u2 = t - 2.25f / 2.75f;
+        const float u3 = t - 2.625f / 2.75f;
+        const float b = 7.5625f * u1 * u1 + 0.75f;
+        const float c = 7.5625f * u2 * u2 + 0.9375f;
+        const float d = 7.5625f * u3 * u3 + 0.984375f;
+        return t < 1 / 2.75f ? a : t < 2 / 2.75f ? b : t < 2.5f / 2.75f ? c : d;
+    }
+
+    template <EasingType Type>
+    inline float evaluate(float t) {
+        constexpr float c1 = 1.70158f;
+        constexpr float c3 = c1 + 1;
+        if constexpr (Type == EasingType::Linear) {
+            return t;
+        } else if constexpr (Type == EasingType::EaseIn) {
+            return t * t;
+        } else if constexpr (Type == EasingType::EaseOut) {
+            const float u = 1 - t;
+            return 1 - u * u;
+        } else if constexpr (Type == EasingType::EaseInOut) {
+            const float u = 2 - 2 * t;
+            return t < 0.5f ? 2 * t * t : 1 - u * u * 0.5f;
+        } else if constexpr (Type == EasingType::BounceIn) {
+            return 1 - bounceOutSelect(1 - t);
+        } else if constexpr (Type == EasingType::BounceOut) {
+            return bounceOutSelect(t);
+        } else if constexpr (Type == EasingType::BackIn) {
+            return c3 * t * t * t - c1 * t * t;
+        } else if constexpr (Type == EasingType::BackOut) {
+            const float u = t - 1;
+            return 1 + c3 * u * u * u + c1 * u * u;
+        } else {
+            return EasingTables::sample(Type, t);
+        }
+    }
+
+    template <EasingType Type>
+    inline void applyBatch(const float* progress, float* out, size_t count) {
+        if constexpr (Type == EasingType::ElasticIn || Type == EasingType::ElasticOut) {
+            // Таблица ищется один раз на пакет
+            const EasingTables::Table& table = *EasingTables::find(Type);
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = EasingTables::sample(table, progress[i]);
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = evaluate<Type>(progress[i]);
+            }
+        }
+    }
+
+    // Одна кривая на весь пакет; elastic берётся из таблицы, если она включена и её граница ошибки в пределах errorBound
+    inline void applyBatch(EasingType type, const float* progress, float* out, size_t count) {
+        switch (type) {
+            case EasingType::Linear: return applyBatch<EasingType::Linear>(progress, out, count);
+            case EasingType::EaseIn: return applyBatch<EasingType::EaseIn>(progress, out, count);
+            case EasingType::EaseOut: return applyBatch<EasingType::EaseOut>(progress, out, count);
+            case EasingType::EaseInOut: return applyBatch<EasingType::EaseInOut>(progress, out, count);
+            case EasingType::BounceIn: return applyBatch<EasingType::BounceIn>(progress, out, count);
+            case EasingType::BounceOut: return applyBatch<EasingType::BounceOut>(progress, out, count);
+            case EasingType::BackIn: return applyBatch<EasingType::BackIn>(progress, out, count);
+            case EasingType::BackOut: return applyBatch<EasingType::BackOut>(progress, out, count);
+            case EasingType::ElasticIn:
+                if (EasingTables::usable(type)) return applyBatch<EasingType::ElasticIn>(progress, out, count);
+                break;
+            case EasingType::ElasticOut:
+                if (EasingTables::usable(type)) return applyBatch<EasingType::ElasticOut>(progress, out, count);
+                break;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = applyEasing(type, progress[i]);
+        }
+    }
+}
+
+// Дескриптор анимации: слот + поколение. Устаревший дескриптор просто ничего не находит.
+struct AnimationHandle {
+    static constexpr uint32_t invalidSlot = 0xFFFFFFFFu;
+
+    uint32_t slot = invalidSlot;
+    uint32_t generation = 0;
+
+    bool valid() const { return slot != invalidSlot; }
+};
+
+// Callback анимации: лямбда до 48 байт хранится на месте, без аллокаций
+using AnimationCallback = InlineFunction<void()>;
+
+// Ключевой кадр дорожки: куда, за сколько, с каким easing и что вызвать по прибытии
+struct Keyframe {
+    sf::Vector2f position;
+    float duration = 1.0f;
+    EasingType easing = EasingType::Linear;
+    AnimationCallback onReached;
+};
+
+// Хранилище дорожек анимации столбцами (struct-of-arrays), одна запись на дорожку.
+// Горячие поля описывают текущий сегмент (старт, цель, время, длительность, easing, флаги) и читаются
+// каждый кадр; остальные ключевые кадры лежат в холодном массиве и подгружаются курсором.
+class AnimationStorage {
+public:
+    enum Flags : uint8_t {
+        Finished = 1 << 0,
+        Cancelled = 1 << 1
+    };
+
+    // Горячие столбцы
+    std::vector<sf::Vector2f> startPos;
+    std::vector<sf::Vector2f> targetPos;
+    std::vector<double> startTime;
+    std::vector<float> duration;
+    std::vector<EasingType> easing;
+    std::vector<uint8_t> flags;
+
+    // Холодные столбцы
+    std::vector<tgui::Widget::Ptr> widget;
+    std::vector<AnimationCallback> onComplete; // callback текущего сегмента
+    std::vector<std::vector<Keyframe>> keyframes;  // ключевые кадры после первого
+    std::vector<uint32_t> cursor;                  // следующий ключевой кадр в keyframes
+    std::vector<uint32_t> slotOf;
+
+    size_t size() const { return flags.size(); }
+
+    // Дескриптор без записи - для дорожки, которая стартует позже (см. place)
+    AnimationHandle reserve() {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slotDense.size());
+            slotDense.push_back(0);
+            slotGeneration.push_back(0);
+        }
+        slotDense[slot] = reservedIndex;
+        return AnimationHandle{ slot, slotGeneration[slot] };
+    }
+
+    bool reserved(AnimationHandle handle) const {
+        return live(handle) && slotDense[handle.slot] == reservedIndex;
+    }
+
+    void unreserve(AnimationHandle handle) {
+        if (reserved(handle)) release(handle.slot);
+    }
+
+    // Дорожка из first и rest; у одиночного перемещения rest пустой и ничего не выделяет
+    AnimationHandle push(tgui::Widget::Ptr target, sf::Vector2f from, double start, Keyframe first,
+                         std::vector<Keyframe> rest) {
+        return place(reserve(), std::move(target), from, start, std::move(first), std::move(rest));
+    }
+
+    // Запись дорожки под ранее зарезервированный дескриптор
+    AnimationHandle place(AnimationHandle handle, tgui::Widget::Ptr target, sf::Vector2f from, double start,
+                          Keyframe first, std::vector<Keyframe> rest) {
+        const uint32_t slot = handle.slot;
+        slotDense[slot] = static_cast<uint32_t>(size());
+
+        startPos.push_back(from);
+        targetPos.push_back(first.position);
+        startTime.push_back(start);
+        duration.push_back(first.duration);
+        easing.push_back(first.easing);
+        flags.push_back(0);
+        widget.push_back(std::move(target));
+        onComplete.push_back(std::move(first.onReached));
+        keyframes.push_back(std::move(rest));
+        cursor.push_back(0);
+        slotOf.push_back(slot);
+
+        return handle;
+    }
+
+    // Переход дорожки к следующему ключевому кадру. Сегмент начинается ровно там и тогда,
+    // где закончился предыдущий. false - кадров больше нет.
+    bool advance(size_t index) {
+        std::vector<Keyframe>& rest = keyframes[index];
+        if (cursor[index] >= rest.size()) return false;
+
+        Keyframe& next = rest[cursor[index]++];
+        startPos[index] = targetPos[index];
+        startTime[index] += duration[index];
+        targetPos[index] = next.position;
+        duration[index] = next.duration;
+        easing[index] = next.easing;
+        onComplete[index] = std::move(next.onReached);
+        return true;
+    }
+
+    // Плотный индекс живой анимации по дескриптору
+    bool find(AnimationHandle handle, size_t& index) const {
+        if (!live(handle) || slotDense[handle.slot] == reservedIndex) {
+            return false;
+        }
+        index = slotDense[handle.slot];
+        return true;
+    }
+
+    // Стабильное уплотнение на месте: порядок оставшихся не меняется, память не выделяется
+    void compact() {
+        const size_t count = size();
+        size_t write = 0;
+        for (size_t read = 0; read < count; ++read) {
+            if (flags[read] & (Finished | Cancelled)) {
+                release(slotOf[read]);
+                continue;
+            }
+            if (write != read) {
+                startPos[write] = startPos[read];
+                targetPos[write] = targetPos[read];
+                startTime[write] = startTime[read];
+                duration[write] = duration[read];
+                easing[write] = easing[read];
+                flags[write] = flags[read];
+                widget[write] = std::move(widget[read]);
+                onComplete[write] = std::move(onComplete[read]);
+                keyframes[write] = std::move(keyframes[read]);
+                cursor[write] = cursor[read];
+                slotOf[write] = slotOf[read];
+                slotDense[slotOf[write]] = static_cast<uint32_t>(write);
+            }
+            ++write;
+        }
+        resize(write);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < size(); ++i) {
+            release(slotOf[i]);
+        }
+        resize(0);
+    }
+
+private:
+    static constexpr uint32_t reservedIndex = 0xFFFFFFFFu;
+
+    bool live(AnimationHandle handle) const {
+        return handle.valid() && handle.slot < slotDense.size() &&
+               slotGeneration[handle.slot] == handle.generation;
+    }
+
+    void release(uint32_t slot) {
+        ++slotGeneration[slot];
+        freeSlots.push_back(slot);
+    }
+
+    // Уменьшение размера не освобождает ёмкость - следующие кадры не аллоцируют
+    void resize(size_t count) {
+        startPos.resize(count);
+        targetPos.resize(count);
+        startTime.resize(count);
+        duration.resize(count);
+        easing.resize(count);
+        flags.resize(count);
+        widget.resize(count);
+        onComplete.resize(count);
+        keyframes.resize(count);
+        cursor.resize(count);
+        slotOf.resize(count);
+    }
+
+    std::vector<uint32_t> slotDense;
+    std::vector<uint32_t> slotGeneration;
+    std::vector<uint32_t> freeSlots;
+};
+
+// Команда из другого потока: рендер-поток выполняет её в начале updateAnimations()
+struct AnimationCommand {
+    enum class Type : uint8_t {
+        None,
+        Track,       // дорожка keyframes для widget, через delay секунд
+        Cancel,      // cancel(handle)
+        CancelTimer, // cancel(timer)
+        Stop,        // stop(widget)
+        Call         // callback через delay секунд
+    };
+
+    Type type = Type::None;
     tgui::Widget::Ptr widget;
-    sf::Vector2f startPos;
-    sf::Vector2f targetPos;
-    float duration;
-    EasingType easingType;
-    std::chrono::steady_clock::time_point startTime;
-    bool completed = false;
-    std::atomic<bool> cancelled{false};
-    std::function<void()> onComplete;
-    
-    AnimationStep() : easingType(EasingType::Linear) {}
-    AnimationStep(AnimationStep&& other) noexcept 
-        : widget(std::move(other.widget))
-        , startPos(other.startPos)
-        , targetPos(other.targetPos)
-        , duration(other.duration)
-        , easingType(other.easingType)
-        , startTime(other.startTime)
-        , completed(other.completed)
-        , cancelled(other.cancelled.load())
-        , onComplete(std::move(other.onComplete))
-    {}
-    
-    AnimationStep& operator=(AnimationStep&& other) noexcept {
-        if (this != &other) {
-            widget = std::move(other.widget);
-            startPos = other.startPos;
-            targetPos = other.targetPos;
-            duration = other.duration;
-            easingType = other.easingType;
-            startTime = other.startTime;
-            completed = other.completed;
-            cancelled.store(other.cancelled.load());
-            onComplete = std::move(other.onComplete);
-        }
-        return *this;
-    }
-    
-    AnimationStep(const AnimationStep&) = delete;
-    AnimationStep& operator=(const AnimationStep&) = delete;
+    std::vector<Keyframe> keyframes;
+    double delay = 0;
+    AnimationHandle handle;
+    TimerHandle timer;
+    AnimationCallback callback;
 };
 
+// Хранилище, таймеры и callback'и принадлежат рендер-потоку (тому, что вызвал initialize()) и живут без мьютекса.
+// Вызовы API из других потоков не трогают их, а становятся командами в lock-free очереди.
 class AnimationSystem {
+public:
+    static constexpr size_t commandCapacity = 1024;
+
 private:
-    static std::vector<AnimationStep> activeAnimations;
+    static AnimationStorage animations;
     static std::atomic<bool> systemActive;
-    static std::mutex animationMutex;
-    static bool isAnimating;
+    static MpscQueue<AnimationCommand, commandCapacity> commands;
+    static std::atomic<uint64_t> droppedCommands;
+    static std::thread::id renderThread;
+    static bool updating; // внутри updateAnimations() - уплотнять хранилище нельзя
+    static bool isAnimating; // идут дорожки; ждущие таймеры и отложенные старты сюда не входят
+    static AnimationClock clock;
+    
+    // Рабочие буферы кадра: активные анимации, разложенные по типу easing
+    static std::array<std::vector<uint32_t>, EasingFunctions::typeCount> easingIndex;
+    static std::array<std::vector<float>, EasingFunctions::typeCount> easingProgress;
+    static std::vector<float> easedProgress;
+    static std::vector<AnimationCallback> completed; // callback'и завершённых сегментов этого кадра
+    
+    // Отложенный старт дорожек и прочие таймеры - на колесе, без проверки каждый кадр
+    struct PendingTrack {
+        AnimationHandle handle;
+        TimerHandle timer;
+        tgui::Widget::Ptr widget;
+        std::vector<Keyframe> keyframes;
+        double startTime = 0;
+    };
+    static TimerWheel timers;
+    static std::vector<PendingTrack> pendingTracks; // по слоту дескриптора
+
+    // Время анимаций в секундах от initialize()
+    static double now() {
+        return clock.now();
+    }
+
+    static bool offRenderThread() {
+        return std::this_thread::get_id() != renderThread;
+    }
+    
+    static bool post(AnimationCommand command) {
+        if (commands.tryPush(std::move(command))) return true;
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    static void postTrack(tgui::Widget::Ptr widget, std::vector<Keyframe> keyframes, double delay) {
+        AnimationCommand command;
+        command.type = AnimationCommand::Type::Track;
+        command.widget = std::move(widget);
+        command.keyframes = std::move(keyframes);
+        command.delay = delay;
+        post(std::move(command));
+    }
+    
+    static void execute(AnimationCommand& command) {
+        switch (command.type) {
+            case AnimationCommand::Type::Track:
+                if (command.delay > 0) trackAfter(command.delay, std::move(command.widget), std::move(command.keyframes));
+                else track(std::move(command.widget), std::move(command.keyframes));
+                break;
+            case AnimationCommand::Type::Cancel: cancel(command.handle); break;
+            case AnimationCommand::Type::CancelTimer: cancel(command.timer); break;
+            case AnimationCommand::Type::Stop: stop(std::move(command.widget)); break;
+            case AnimationCommand::Type::Call:
+                if (command.delay > 0) after(command.delay, std::move(command.callback));
+                else if (command.callback) command.callback();
+                break;
+            default: break;
+        }
+    }
+    
+    // Дорожка стартует сейчас из текущей позиции виджета
+    static AnimationHandle push(tgui::Widget::Ptr widget, Keyframe first, std::vector<Keyframe> rest = {}) {
+        const sf::Vector2f startPos = widget->getPosition();
+        isAnimating = true;
+        return animations.push(std::move(widget), startPos, now(), std::move(first), std::move(rest));
+    }
 
 public:
-    static void initialize() {
+    // Вызывать из рендер-потока: он становится владельцем анимаций
+    static void initialize(ClockMode mode = ClockMode::RealTime, double fixedStep = 1.0 / 60) {
+        clock.setMode(mode, fixedStep);
+        clock.reset();
+        timers.reset(); // часы снова с нуля - иначе колесо ждёт старого lastTime
+        renderThread = std::this_thread::get_id();
         systemActive = true;
         isAnimating = false;
     }
     
     static void shutdown() {
-        std::lock_guard<std::mutex> lock(animationMutex);
-        systemActive = false;
-        for (auto& step : activeAnimations) {
-            step.cancelled = true;
+        if (offRenderThread()) {
+            systemActive = false;
+            return;
         }
-        activeAnimations.clear();
+        stop(nullptr);
+        timers.clear();
+        AnimationCommand command;
+        while (commands.tryPop(command)) {}
+        systemActive = false;
         isAnimating = false;
     }
     
+    // Команда от рабочего потока (симуляция, загрузка, сеть). false - очередь переполнена, команда отброшена.
+    static bool submit(AnimationCommand command) {
+        return systemActive && post(std::move(command));
+    }
+    
+    // Сколько команд не влезло в очередь с начала работы
+    static uint64_t dropped() {
+        return droppedCommands.load(std::memory_order_relaxed);
+    }
+    
     // Простая анимация перемещения с easing
-    static void move(tgui::Widget::Ptr widget, sf::Vector2f targetPos, float duration = 1.0f, EasingType easing = EasingType::Linear) {
-        if (!systemActive || !widget) return;
+    static AnimationHandle move(tgui::Widget::Ptr widget, sf::Vector2f targetPos, float duration = 1.0f, EasingType easing = EasingType::Linear) {
+        if (!systemActive || !widget) return {};
         
-        AnimationStep step;
-        step.widget = widget;
-        step.startPos = widget->getPosition();
-        step.targetPos = targetPos;
-        step.duration = duration;
-        step.easingType = easing;
-        step.startTime = std::chrono::steady_clock::now();
-        
-        std::lock_guard<std::mutex> lock(animationMutex);
-        activeAnimations.push_back(std::move(step));
-        isAnimating = true;
+        if (offRenderThread()) {
+            postTrack(std::move(widget), { Keyframe{ targetPos, duration, easing, nullptr } }, 0);
+            return {};
+        }
+        return push(std::move(widget), Keyframe{ targetPos, duration, easing, nullptr });
     }
     
     // Анимация с callback при завершении
-    static void moveWithCallback(tgui::Widget::Ptr widget, sf::Vector2f targetPos, float duration, 
-                                std::function<void()> callback, EasingType easing = EasingType::Linear) {
-        if (!systemActive || !widget) return;
+    static AnimationHandle moveWithCallback(tgui::Widget::Ptr widget, sf::Vector2f targetPos, float duration, 
+                                AnimationCallback callback, EasingType easing = EasingType::Linear) {
+        if (!systemActive || !widget) return {};
         
-        AnimationStep step;
-        step.widget = widget;
-        step.startPos = widget->getPosition();
-        step.targetPos = targetPos;
-        step.duration = duration;
-        step.easingType = easing;
-        step.startTime = std::chrono::steady_clock::now();
-        step.onComplete = callback;
+        if (offRenderThread()) {
+            std::vector<Keyframe> keyframes;
+            keyframes.push_back(Keyframe{ targetPos, duration, easing, std::move(callback) });
+            postTrack(std::move(widget), std::move(keyframes), 0);
+            return {};
+        }
+        return push(std::move(widget), Keyframe{ targetPos, duration, easing, std::move(callback) });
+    }
+    
+    // Дорожка ключевых кадров: одна запись на виджет, сегменты идут друг за другом.
+    // Из чужого потока дескриптор не возвращается - дорожка появится на следующем кадре.
+    static AnimationHandle track(tgui::Widget::Ptr widget, std::vector<Keyframe> keyframes) {
+        if (!systemActive || !widget || keyframes.empty()) return {};
         
-        std::lock_guard<std::mutex> lock(animationMutex);
-        activeAnimations.push_back(std::move(step));
-        isAnimating = true;
+        if (offRenderThread()) {
+            postTrack(std::move(widget), std::move(keyframes), 0);
+            return {};
+        }
+        
+        Keyframe first = std::move(keyframes.front());
+        keyframes.erase(keyframes.begin());
+        return push(std::move(widget), std::move(first), std::move(keyframes));
+    }
+    
+    // Дорожка, которая стартует через delay секунд. Дескриптор годится для cancel() и до старта.
+    static AnimationHandle trackAfter(double delay, tgui::Widget::Ptr widget, std::vector<Keyframe> keyframes) {
+        if (!systemActive || !widget || keyframes.empty()) return {};
+        
+        if (offRenderThread()) {
+            postTrack(std::move(widget), std::move(keyframes), std::max(delay, 0.0));
+            return {};
+        }
+        
+        const AnimationHandle handle = animations.reserve();
+        if (pendingTracks.size() <= handle.slot) {
+            pendingTracks.resize(handle.slot + 1);
+        }
+        
+        PendingTrack& pending = pendingTracks[handle.slot];
+        pending.handle = handle;
+        pending.widget = std::move(widget);
+        pending.keyframes = std::move(keyframes);
+        pending.startTime = now() + std::max(delay, 0.0);
+        pending.timer = timers.scheduleAt(pending.startTime, [handle] { startPending(handle); });
+        return handle;
+    }
+    
+    static AnimationHandle moveAfter(double delay, tgui::Widget::Ptr widget, sf::Vector2f targetPos,
+                                     float duration = 1.0f, EasingType easing = EasingType::Linear) {
+        std::vector<Keyframe> keyframes;
+        keyframes.push_back(Keyframe{ targetPos, duration, easing, nullptr });
+        return trackAfter(delay, std::move(widget), std::move(keyframes));
+    }
+    
+    // Игровое событие через delay секунд на часах анимаций; вызывается из updateAnimations()
+    static TimerHandle after(double delay, AnimationCallback callback) {
+        if (!systemActive) return {};
+        
+        if (offRenderThread()) {
+            AnimationCommand command;
+            command.type = AnimationCommand::Type::Call;
+            command.callback = std::move(callback);
+            command.delay = std::max(delay, 0.0);
+            post(std::move(command));
+            return {};
+        }
+        
+        return timers.scheduleAt(now() + std::max(delay, 0.0), std::move(callback));
+    }
+    
+    // Из чужого потока - true, если команда отмены поставлена в очередь
+    static bool cancel(TimerHandle handle) {
+        if (offRenderThread()) {
+            AnimationCommand command;
+            command.type = AnimationCommand::Type::CancelTimer;
+            command.timer = handle;
+            return post(std::move(command));
+        }
+        return timers.cancel(handle);
     }
     
     // Цепочка анимаций с одинаковым временем и easing для всех шагов
-    static void sequence(tgui::Widget::Ptr widget, std::initializer_list<sf::Vector2f> positions, 
+    static AnimationHandle sequence(tgui::Widget::Ptr widget, std::initializer_list<sf::Vector2f> positions, 
                         float stepDuration = 1.0f, EasingType easing = EasingType::Linear) {
-        if (!systemActive || !widget || positions.size() == 0) return;
+        if (!systemActive || !widget || positions.size() == 0) return {};
         
-        auto posList = std::vector<sf::Vector2f>(positions);
-        auto durations = std::vector<float>(posList.size(), stepDuration);
-        auto easings = std::vector<EasingType>(posList.size(), easing);
-        sequenceAdvanced(widget, posList, durations, easings);
+        std::vector<Keyframe> keyframes;
+        keyframes.reserve(positions.size());
+        for (const sf::Vector2f& position : positions) {
+            keyframes.push_back(Keyframe{ position, stepDuration, easing, nullptr });
+        }
+        return track(std::move(widget), std::move(keyframes));
     }
     
     // Цепочка анимаций с разным временем для каждого шага
-    static void sequenceAdvanced(tgui::Widget::Ptr widget, std::initializer_list<sf::Vector2f> positions, 
+    static AnimationHandle sequenceAdvanced(tgui::Widget::Ptr widget, std::initializer_list<sf::Vector2f> positions, 
                                 std::initializer_list<float> durations, std::initializer_list<EasingType> easings = {}) {
-        if (!systemActive || !widget || positions.size() == 0 || positions.size() != durations.size()) return;
+        if (!systemActive || !widget || positions.size() == 0 || positions.size() != durations.size()) return {};
         
-        auto posVec = std::vector<sf::Vector2f>(positions);
-        auto durVec = std::vector<float>(durations);
-        auto easeVec = std::vector<EasingType>(easings);
-        if (easeVec.size() != posVec.size()) {
-            easeVec = std::vector<EasingType>(posVec.size(), EasingType::Linear);
-        }
-        sequenceAdvanced(widget, posVec, durVec, easeVec);
+        return sequenceAdvanced(std::move(widget), std::vector<sf::Vector2f>(positions),
+                                std::vector<float>(durations), std::vector<EasingType>(easings));
     }
     
     // Цепочка анимаций с разным временем и easing (версия с векторами)
-    static void sequenceAdvanced(tgui::Widget::Ptr widget, const std::vector<sf::Vector2f>& positions, 
+    static AnimationHandle sequenceAdvanced(tgui::Widget::Ptr widget, const std::vector<sf::Vector2f>& positions, 
                                 const std::vector<float>& durations, const std::vector<EasingType>& easings = {}) {
-        if (!systemActive || !widget || positions.empty() || positions.size() != durations.size()) return;
-        
-        std::vector<EasingType> actualEasings = easings;
-        if (actualEasings.size() != positions.size()) {
-            actualEasings = std::vector<EasingType>(positions.size(), EasingType::Linear);
-        }
+        if (!systemActive || !widget || positions.empty() || positions.size() != durations.size()) return {};
         
-        float totalDelay = 0;
+        const bool sameEasings = easings.size() == positions.size();
         
+        std::vector<Keyframe> keyframes;
+        keyframes.reserve(positions.size());
         for (size_t i = 0; i < positions.size(); ++i) {
-            AnimationStep step;
-            step.widget = widget;
-            step.targetPos = positions[i];
-            step.duration = durations[i];
-            step.easingType = actualEasings[i];
-            step.startTime = std::chrono::steady_clock::now() + 
-                            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
-                                std::chrono::duration<float>(totalDelay));
-            
-            std::lock_guard<std::mutex> lock(animationMutex);
-            activeAnimations.push_back(std::move(step));
-            
-            totalDelay += durations[i];
+            keyframes.push_back(Keyframe{ positions[i], durations[i],
+                                          sameEasings ? easings[i] : EasingType::Linear, nullptr });
         }
-        
-        isAnimating = true;
+        return track(std::move(widget), std::move(keyframes));
     }
     
     // Цепочка анимаций с callback после каждого шага
-    static void sequenceWithCallbacks(tgui::Widget::Ptr widget, 
+    static AnimationHandle sequenceWithCallbacks(tgui::Widget::Ptr widget, 
                                      std::initializer_list<sf::Vector2f> positions, 
                                      std::initializer_list<float> durations,
-                                     std::initializer_list<std::function<void()>> callbacks,
+                                     std::initializer_list<AnimationCallback> callbacks,
                                      std::initializer_list<EasingType> easings = {}) {
         if (!systemActive || !widget || positions.size() == 0 || 
-            positions.size() != durations.size() || positions.size() != callbacks.size()) return;
+            positions.size() != durations.size() || positions.size() != callbacks.size()) return {};
+        
+        const bool sameEasings = easings.size() == positions.size();
+        auto pos = positions.begin();
+        auto dur = durations.begin();
+        auto cb = callbacks.begin();
+        auto ease = easings.begin();
         
-        auto posVec = std::vector<sf::Vector2f>(positions);
-        auto durVec = std::vector<float>(durations);
-        auto cbVec = std::vector<std::function<void()>>(callbacks);
-        auto easeVec = std::vector<EasingType>(easings);
-        if (easeVec.size() != posVec.size()) {
-            easeVec = std::vector<EasingType>(posVec.size(), EasingType::Linear);
+        std::vector<Keyframe> keyframes;
+        keyframes.reserve(positions.size());
+        for (; pos != positions.end(); ++pos, ++dur, ++cb) {
+            keyframes.push_back(Keyframe{ *pos, *dur, sameEasings ? *ease++ : EasingType::Linear, *cb });
         }
+        return track(std::move(widget), std::move(keyframes));
+    }
+    
+    // Кадр: команды других потоков, затем столько шагов, сколько велят часы
+    // (RealTime - один, FixedStep - по накопленному времени, Manual - один в текущий момент).
+    // true - виджеты сдвинулись или сработали таймеры: кадр надо перерисовать
+    static bool updateAnimations() {
+        if (!systemActive) return false;
         
-        float totalDelay = 0;
+        // Команды других потоков - один проход по очереди за кадр
+        bool changed = false;
+        AnimationCommand command;
+        while (commands.tryPop(command)) {
+            execute(command);
+            changed = true;
+        }
         
-        for (size_t i = 0; i < posVec.size(); ++i) {
-            AnimationStep step;
-            step.widget = widget;
-            step.targetPos = posVec[i];
-            step.duration = durVec[i];
-            step.easingType = easeVec[i];
-            step.startTime = std::chrono::steady_clock::now() + 
-                            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
-                                std::chrono::duration<float>(totalDelay));
-            step.onComplete = cbVec[i];
-            
-            std::lock_guard<std::mutex> lock(animationMutex);
-            activeAnimations.push_back(std::move(step));
-            
-            totalDelay += durVec[i];
+        const int steps = clock.frameSteps();
+        for (int i = 0; i < steps; ++i) {
+            changed |= updateStep(clock.nextStep());
+        }
+        return changed;
+    }
+    
+    // Ручной режим: сдвинуть виртуальное время и обновить
+    static void step(double seconds) {
+        clock.advance(seconds);
+        updateAnimations();
+    }
+    
+    // Режим часов; время анимаций при этом не сбрасывается
+    static void setClock(ClockMode mode, double fixedStep = 1.0 / 60) {
+        clock.setMode(mode, fixedStep);
+    }
+    
+    // Свой источник времени для RealTime/FixedStep (nullptr - steady_clock)
+    static void setTimeSource(AnimationClock::TimeSource source) {
+        clock.setSource(std::move(source));
+    }
+    
+    static double time() {
+        return clock.now();
+    }
+    
+    // Доля фиксированного шага в аккумуляторе - для интерполяции отрисовки
+    static double stepAlpha() {
+        return clock.alpha();
+    }
+    
+    // Идут дорожки - кадр нужен каждый кадр. Одни таймеры занятостью не считаются: до них можно спать
+    static bool isBusy() {
+        return isAnimating && systemActive;
+    }
+    
+    // Секунды по часам анимаций до ближайшего таймера (after(), отложенный старт дорожки); нет - HUGE_VAL
+    static double untilNextTimer() {
+        if (!systemActive) return HUGE_VAL;
+        return timers.nextTime() - now();
+    }
+    
+    // Отмена одной анимации по дескриптору
+    // Из чужого потока - true, если команда отмены поставлена в очередь
+    static bool cancel(AnimationHandle handle) {
+        if (offRenderThread()) {
+            AnimationCommand command;
+            command.type = AnimationCommand::Type::Cancel;
+            command.handle = handle;
+            return post(std::move(command));
         }
         
-        isAnimating = true;
+        if (animations.reserved(handle)) {
+            PendingTrack& pending = pendingTracks[handle.slot];
+            timers.cancel(pending.timer);
+            pending = PendingTrack{};
+            animations.unreserve(handle);
+            return true;
+        }
+        
+        size_t index;
+        if (!animations.find(handle, index)) return false;
+        animations.flags[index] |= AnimationStorage::Cancelled;
+        return true;
+    }
+    
+    static void stop(tgui::Widget::Ptr widget = nullptr) {
+        if (offRenderThread()) {
+            AnimationCommand command;
+            command.type = AnimationCommand::Type::Stop;
+            command.widget = std::move(widget);
+            post(std::move(command));
+            return;
+        }
+        
+        // Из callback'а внутри updateAnimations() только помечаем - уплотнит сам кадр
+        for (size_t i = 0; i < animations.size(); ++i) {
+            if (!widget || animations.widget[i] == widget) {
+                animations.flags[i] |= AnimationStorage::Cancelled;
+            }
+        }
+        if (!updating) {
+            animations.compact();
+        }
+        dropPending(widget);
+        isAnimating = animations.size() != 0;
     }
     
-    static void updateAnimations() {
-        if (!systemActive) return;
+private:
+    // Один шаг обновления в момент currentTime по часам анимаций; true - что-то сдвинулось или сработало
+    static bool updateStep(double currentTime) {
+        updating = true;
         
-        std::lock_guard<std::mutex> lock(animationMutex);
+        const bool fired = timers.advance(currentTime) != 0;
         
-        if (activeAnimations.empty()) {
+        const size_t count = animations.size();
+        if (count == 0) {
+            updating = false;
             isAnimating = false;
-            return;
+            return fired;
         }
         
-        auto currentTime = std::chrono::steady_clock::now();
-        std::vector<AnimationStep> remainingAnimations;
+        bool anyRemoved = false;
         
-        for (auto& step : activeAnimations) {
-            if (step.completed || step.cancelled || step.widget == nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            if (animations.flags[i] & (AnimationStorage::Finished | AnimationStorage::Cancelled)) {
+                anyRemoved = true;
                 continue;
             }
             
-            // Если это отложенная анимация, проверяем время старта
-            if (step.startTime > currentTime) {
-                remainingAnimations.push_back(std::move(step));
-                continue;
-            }
-            
-            // Для активных анимаций устанавливаем стартовую позицию при первом обновлении
-            if (step.startPos == sf::Vector2f(0, 0)) {
-                step.startPos = step.widget->getPosition();
+            // Закончившиеся к этому кадру сегменты: позиция в цель, callback, следующий ключевой кадр
+            bool finished = false;
+            while (currentTime - animations.startTime[i] >= animations.duration[i]) {
+                const sf::Vector2f target = animations.targetPos[i];
+                animations.widget[i]->setPosition(target.x, target.y);
+                
+                // Callback откладывается до конца кадра - внутри цикла хранилище не меняется
+                if (animations.onComplete[i]) {
+                    completed.push_back(std::move(animations.onComplete[i]));
+                }
+                
+                if (!animations.advance(i)) {
+                    animations.flags[i] |= AnimationStorage::Finished;
+                    anyRemoved = true;
+                    finished = true;
+                    break;
+                }
             }
+            if (finished) continue;
             
-            auto elapsed = std::chrono::duration<float>(currentTime - step.startTime).count();
-            float progress = std::min(elapsed / step.duration, 1.0f);
-            
-            // Применяем easing-функцию
-            float easedProgress = EasingFunctions::applyEasing(step.easingType, progress);
+            const float elapsed = static_cast<float>(currentTime - animations.startTime[i]);
+            const float progress = std::max(elapsed / animations.duration[i], 0.0f);
             
-            sf::Vector2f newPos;
-            newPos.x = step.startPos.x + (step.targetPos.x - step.startPos.x) * easedProgress;
-            newPos.y = step.startPos.y + (step.targetPos.y - step.startPos.y) * easedProgress;
+            // Дальше - пакетом по типу easing
+            const size_t type = static_cast<size_t>(animations.easing[i]);
+            easingIndex[type].push_back(static_cast<uint32_t>(i));
+            easingProgress[type].push_back(progress);
+        }
+        
+        // Каждая группа easing считается одним циклом, затем позиции пишутся в виджеты
+        for (size_t type = 0; type < EasingFunctions::typeCount; ++type) {
+            const size_t groupSize = easingIndex[type].size();
+            if (groupSize == 0) continue;
             
-            step.widget->setPosition(newPos.x, newPos.y);
+            easedProgress.resize(groupSize);
+            EasingFunctions::applyBatch(static_cast<EasingType>(type), easingProgress[type].data(),
+                                        easedProgress.data(), groupSize);
             
-            if (progress >= 1.0f) {
-                step.completed = true;
-                step.widget->setPosition(step.targetPos.x, step.targetPos.y);
-                
-                // Вызываем callback если есть
-                if (step.onComplete) {
-                    step.onComplete();
-                }
-            } else {
-                remainingAnimations.push_back(std::move(step));
+            for (size_t j = 0; j < groupSize; ++j) {
+                const uint32_t i = easingIndex[type][j];
+                const sf::Vector2f start = animations.startPos[i];
+                const sf::Vector2f target = animations.targetPos[i];
+                const float eased = easedProgress[j];
+                animations.widget[i]->setPosition(start.x + (target.x - start.x) * eased,
+                                                  start.y + (target.y - start.y) * eased);
             }
+            
+            // clear() сохраняет ёмкость - следующий кадр не аллоцирует
+            easingIndex[type].clear();
+            easingProgress[type].clear();
+        }
+        
+        updating = false;
+        if (anyRemoved) {
+            animations.compact();
         }
+        isAnimating = animations.size() != 0;
         
-        activeAnimations = std::move(remainingAnimations);
-        isAnimating = !activeAnimations.empty();
+        // Пачка callback'ов кадра: могут свободно запускать и останавливать анимации
+        for (size_t i = 0; i < completed.size(); ++i) {
+            completed[i]();
+        }
+        completed.clear();
+        return true;
     }
     
-    static bool isBusy() {
-        return isAnimating && systemActive;
+    // Срабатывание таймера отложенной дорожки: отсчёт идёт от запланированного момента, не от кадра
+    static void startPending(AnimationHandle handle) {
+        if (!animations.reserved(handle)) return;
+        
+        PendingTrack& pending = pendingTracks[handle.slot];
+        std::vector<Keyframe> keyframes = std::move(pending.keyframes);
+        tgui::Widget::Ptr widget = std::move(pending.widget);
+        const double startTime = pending.startTime;
+        pending = PendingTrack{};
+        
+        Keyframe first = std::move(keyframes.front());
+        keyframes.erase(keyframes.begin());
+        const sf::Vector2f startPos = widget->getPosition();
+        animations.place(handle, std::move(widget), startPos, startTime, std::move(first), std::move(keyframes));
     }
     
-    static void stop(tgui::Widget::Ptr widget = nullptr) {
-        std::lock_guard<std::mutex> lock(animationMutex);
-        if (widget) {
-            std::vector<AnimationStep> remainingAnimations;
-            for (auto& step : activeAnimations) {
-                if (step.widget != widget) {
-                    remainingAnimations.push_back(std::move(step));
-                } else {
-                    step.cancelled = true;
-                }
-            }
-            activeAnimations = std::move(remainingAnimations);
-        } else {
-            for (auto& step : activeAnimations) {
-                step.cancelled = true;
-            }
-            activeAnimations.clear();
+    // Снять ещё не стартовавшие дорожки виджета (nullptr - все)
+    static void dropPending(const tgui::Widget::Ptr& widget) {
+        for (uint32_t slot = 0; slot < pendingTracks.size(); ++slot) {
+            PendingTrack& pending = pendingTracks[slot];
+            if (!pending.widget || (widget && pending.widget != widget)) continue;
+            timers.cancel(pending.timer);
+            animations.unreserve(pending.handle);
+            pending = PendingTrack{};
         }
-        isAnimating = !activeAnimations.empty();
     }
 };
 
-std::vector<AnimationStep> AnimationSystem::activeAnimations;
+AnimationStorage AnimationSystem::animations;
 std::atomic<bool> AnimationSystem::systemActive{false};
-std::mutex AnimationSystem::animationMutex;
+MpscQueue<AnimationCommand, AnimationSystem::commandCapacity> AnimationSystem::commands;
+std::atomic<uint64_t> AnimationSystem::droppedCommands{0};
+std::thread::id AnimationSystem::renderThread;
+bool AnimationSystem::updating = false;
 bool AnimationSystem::isAnimating = false;
+AnimationClock AnimationSystem::clock;
+std::array<std::vector<uint32_t>, EasingFunctions::typeCount> AnimationSystem::easingIndex;
+std::array<std::vector<float>, EasingFunctions::typeCount> AnimationSystem::easingProgress;
+std::vector<float> AnimationSystem::easedProgress;
+std::vector<AnimationCallback> AnimationSystem::completed;
+TimerWheel AnimationSystem::timers;
+std::vector<AnimationSystem::PendingTrack> AnimationSystem::pendingTracks;
+bool EasingTables::enabled = true;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,321 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <TGUI/TGUI.hpp>
+#include <TGUI/Backend/SFML-Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "asset_pack.h"
+#include "command_queue.h"
+#include "inline_function.h"
+#include "texture_atlas.h"
+
+// Фоновая загрузка картинок: PNG декодируются пулом потоков, загрузка в видеопамять -
+// из главного цикла (pump) в пределах бюджета времени на кадр. До готовности виджет показывает заглушку.
+// Важные ассеты (стол, руки, кнопка) декодируются раньше декоративных.
+// Если подключён пак (asset_pack.h), картинки из него не декодируются - пиксели берутся прямо из отображения.
+
+enum class AssetPriority : uint8_t {
+    Critical,
+    Normal,
+    Decorative,
+    Count
+};
+
+// Готовая картинка: страница - общая GPU-текстура файла, part - прямоугольник на ней (весь файл или спрайт атласа).
+// Все спрайты одной страницы атласа получают одну и ту же текстуру - SpriteBatch рисует их одним вызовом.
+// Файл не загрузился - вызов с пустыми страницей и part, чтобы ждущий не остался без ответа
+using AssetReady = InlineFunction<void(const tgui::Texture& page, const tgui::UIntRect& part)>;
+using AssetTask = InlineFunction<void()>;
+
+class AssetLoader {
+public:
+    // workers = 0 - по числу ядер минус главный поток (от 1 до 4)
+    explicit AssetLoader(unsigned workers = 0) {
+        if (workers == 0) {
+            const unsigned cores = std::thread::hardware_concurrency();
+            workers = std::clamp(cores > 1 ? cores - 1 : 1u, 1u, 4u);
+        }
+        for (unsigned i = 0; i < workers; ++i) {
+            threads.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~AssetLoader() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (std::thread& thread : threads) thread.join();
+
+        DecodedFile decoded;
+        while (decodedQueue.tryPop(decoded)) {}
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Полупрозрачный серый квадрат на время загрузки; создаётся при первом вызове (нужен backend TGUI)
+    static const tgui::Texture& placeholder() {
+        static const tgui::Texture texture = [] {
+            const std::uint8_t pixels[4 * 4] = {
+                90, 90, 90, 120,  90, 90, 90, 120,
+                90, 90, 90, 120,  90, 90, 90, 120
+            };
+            tgui::Texture t;
+            t.loadFromPixelData({ 2, 2 }, pixels);
+            return t;
+        }();
+        return texture;
+    }
+
+    // Пак с раскодированными картинками; nullptr - только файлы. Пак должен жить дольше загрузчика.
+    void setPack(const AssetPack* assetPack) { pack = assetPack; }
+
+    // Главный поток. Файл декодируется и загружается в видеопамять один раз, сколько бы кусков ни запросили;
+    // part - кусок картинки (спрайт атласа), пустой - вся картинка
+    void request(const std::string& path, AssetPriority priority, AssetReady onReady, const tgui::UIntRect& part = {}) {
+        File*& slot = fileIndex[path];
+        if (!slot) {
+            files.emplace_back();
+            slot = &files.back();
+            slot->path = path;
+        }
+        File& file = *slot;
+
+        if (file.state == FileState::Ready) {
+            if (onReady) onReady(file.whole, part.width && part.height ? part : file.bounds);
+            return;
+        }
+        if (file.state == FileState::Failed) {
+            if (onReady) onReady(tgui::Texture(), tgui::UIntRect());
+            return;
+        }
+        if (onReady) file.waiting.push_back({ part, std::move(onReady) });
+
+        // Пиксели из пака уже ждут загрузки в видеопамять: старший приоритет лишь переносит их в свою очередь,
+        // рабочие потоки такой файл не трогают (на установке только с паком с диска его не прочитать)
+        if (file.state == FileState::Queued && file.packed) {
+            if (priority < file.priority) promote(file, priority);
+            return;
+        }
+
+        // Есть в паке - декодировать нечего, сразу в очередь загрузки в видеопамять
+        if (file.state == FileState::New && pack) {
+            if (const AssetView pixels = pack->image(path)) {
+                ++inFlight;
+                file.priority = priority;
+                file.state = FileState::Queued;
+                file.packed = true;
+                DecodedFile packed;
+                packed.file = &file;
+                packed.packed = pixels;
+                ready[static_cast<size_t>(priority)].push_back(std::move(packed));
+                return;
+            }
+        }
+
+        // Повторный запрос с более высоким приоритетом ставит файл в очередь ещё раз - возьмёт первый освободившийся
+        if (file.state == FileState::New || priority < file.priority) {
+            if (file.state == FileState::New) ++inFlight;
+            file.priority = priority;
+            file.state = FileState::Queued;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                queues[static_cast<size_t>(priority)].push_back(&file);
+            }
+            queueReady.notify_one();
+        }
+    }
+
+    // Спрайт из атласа, если он там есть, иначе отдельный файл
+    void requestSprite(const TextureAtlas& atlas, const std::string& name, const std::string& fallbackPath,
+                       AssetPriority priority, AssetReady onReady) {
+        if (const AtlasRegion* r = atlas.region(name)) {
+            request(atlas.pageFile(r->page), priority, std::move(onReady), tgui::UIntRect(r->x, r->y, r->width, r->height));
+        } else {
+            request(fallbackPath, priority, std::move(onReady));
+        }
+    }
+
+    // Работа главного потока, которую можно отложить после первого кадра (тема, шрифты)
+    void defer(AssetPriority priority, AssetTask task) {
+        deferred[static_cast<size_t>(priority)].push_back(std::move(task));
+    }
+
+    // Из главного цикла: готовые картинки и отложенные задачи по приоритету, пока не вышел бюджет.
+    // За вызов выполняется хотя бы одна работа, чтобы загрузка не вставала при тяжёлых кадрах.
+    // Возвращает число выполненных работ (0 - виджеты не менялись).
+    size_t pump(double budgetSeconds) {
+        DecodedFile decoded;
+        while (decodedQueue.tryPop(decoded)) {
+            ready[static_cast<size_t>(decoded.file->priority)].push_back(std::move(decoded));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        bool first = true;
+        size_t done = 0;
+        auto withinBudget = [&] {
+            if (first) {
+                first = false;
+                return true;
+            }
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < budgetSeconds;
+        };
+
+        for (size_t p = 0; p < static_cast<size_t>(AssetPriority::Count); ++p) {
+            while (!ready[p].empty() && withinBudget()) {
+                upload(ready[p].front());
+                ready[p].pop_front();
+                ++done;
+            }
+            while (!deferred[p].empty() && withinBudget()) {
+                AssetTask task = std::move(deferred[p].front());
+                deferred[p].pop_front();
+                task();
+                ++done;
+            }
+            if (!ready[p].empty() || !deferred[p].empty()) return done; // младшие приоритеты ждут следующего кадра
+        }
+        return done;
+    }
+
+    // Всё запрошенное загружено и отложенное выполнено
+    bool idle() const {
+        if (inFlight) return false;
+        for (size_t p = 0; p < static_cast<size_t>(AssetPriority::Count); ++p) {
+            if (!ready[p].empty() || !deferred[p].empty()) return false;
+        }
+        return true;
+    }
+
+    size_t pending() const { return inFlight; }
+
+private:
+    enum class FileState : uint8_t { New, Queued, Ready, Failed };
+
+    struct Waiting {
+        tgui::UIntRect part;
+        AssetReady onReady;
+    };
+
+    // Элементы deque не переезжают - потоки держат указатель на File, пока главный поток добавляет новые.
+    // path неизменен после постановки в очередь; claimed - чтобы повторная постановка не декодировала дважды.
+    struct File {
+        std::string path;
+        AssetPriority priority = AssetPriority::Decorative;
+        FileState state = FileState::New;
+        std::atomic<bool> claimed{false};
+        bool packed = false; // пиксели из пака, в ready[] без рабочих потоков
+        std::vector<Waiting> waiting;
+        tgui::Texture whole;   // вся картинка, одна GPU-текстура на файл - копии TGUI делят её
+        tgui::UIntRect bounds; // вся картинка как прямоугольник
+    };
+
+    struct DecodedFile {
+        File* file = nullptr;
+        std::unique_ptr<sf::Image> image; // пусто - не удалось декодировать
+        AssetView packed;                 // либо пиксели из пака
+    };
+
+    void workerLoop() {
+        for (;;) {
+            File* file = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || hasQueued(); });
+                if (stopping) return;
+                for (std::deque<File*>& queue : queues) {
+                    if (queue.empty()) continue;
+                    file = queue.front();
+                    queue.pop_front();
+                    break;
+                }
+            }
+            if (file->claimed.exchange(true, std::memory_order_acq_rel)) continue;
+
+            DecodedFile decoded;
+            decoded.file = file;
+            decoded.image = std::make_unique<sf::Image>();
+            if (!decoded.image->loadFromFile(file->path)) decoded.image.reset();
+
+            // Главный поток разгребает очередь каждый кадр - переполнение лишь короткая пауза
+            while (!decodedQueue.tryPush(std::move(decoded))) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void promote(File& file, AssetPriority priority) {
+        std::deque<DecodedFile>& from = ready[static_cast<size_t>(file.priority)];
+        auto it = std::find_if(from.begin(), from.end(), [&](const DecodedFile& d) { return d.file == &file; });
+        file.priority = priority;
+        if (it == from.end()) return;
+        ready[static_cast<size_t>(priority)].push_back(std::move(*it));
+        from.erase(it);
+    }
+
+    bool hasQueued() const {
+        for (const std::deque<File*>& queue : queues) {
+            if (!queue.empty()) return true;
+        }
+        return false;
+    }
+
+    void upload(DecodedFile& decoded) {
+        File& file = *decoded.file;
+        if (file.state != FileState::Queued) return; // лишний результат повторной постановки
+        --inFlight;
+        if (!decoded.image && !decoded.packed) {
+            std::fprintf(stderr, "asset: cannot load %s\n", file.path.c_str());
+            file.state = FileState::Failed;
+            std::vector<Waiting> waiting;
+            waiting.swap(file.waiting);
+            for (Waiting& w : waiting) w.onReady(tgui::Texture(), tgui::UIntRect());
+            return;
+        }
+
+        file.state = FileState::Ready;
+        const tgui::Vector2u size = decoded.packed ? tgui::Vector2u{ decoded.packed.width, decoded.packed.height }
+                                                   : tgui::Vector2u{ decoded.image->getSize().x, decoded.image->getSize().y };
+        const std::uint8_t* pixels = decoded.packed ? decoded.packed.data : decoded.image->getPixelsPtr();
+        file.whole.loadFromPixelData(size, pixels);
+        file.bounds = tgui::UIntRect(0, 0, size.x, size.y);
+
+        std::vector<Waiting> waiting;
+        waiting.swap(file.waiting);
+        for (Waiting& w : waiting) {
+            w.onReady(file.whole, w.part.width && w.part.height ? w.part : file.bounds);
+        }
+    }
+
+    std::deque<File> files;
+    std::unordered_map<std::string, File*> fileIndex;
+    std::deque<DecodedFile> ready[static_cast<size_t>(AssetPriority::Count)];
+    std::deque<AssetTask> deferred[static_cast<size_t>(AssetPriority::Count)];
+    size_t inFlight = 0; // поставлено в очередь и ещё не загружено (главный поток)
+    const AssetPack* pack = nullptr;
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<File*> queues[static_cast<size_t>(AssetPriority::Count)];
+    bool stopping = false;
+
+    MpscQueue<DecodedFile, 256> decodedQueue;
+    std::vector<std::thread> threads;
+};
+
+#endif
@@ -0,0 +1,223 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <TGUI/TGUI.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Пак ассетов (tools/pack_assets.cpp): один файл с оглавлением, картинки уже раскодированы в RGBA.
+// Файл отображается в память целиком; текстуры и шрифты получают указатели прямо в отображение,
+// поэтому старт - одно открытие файла без декодирования PNG, а имена (в том числе кириллица) - просто байты UTF-8.
+//
+// Формат (little-endian):
+//   AssetPackHeader
+//   AssetPackEntry[entryCount]  - отсортированы по имени
+//   имена (UTF-8, без нуля), данные (каждый блок выровнен на 16)
+
+struct AssetPackHeader {
+    char magic[4];          // "DIOD"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+enum class AssetPackType : uint32_t {
+    Raw,    // байты файла как есть (шрифт, тема)
+    Image   // width * height * 4 байт RGBA
+};
+
+struct AssetPackEntry {
+    uint64_t offset;        // от начала файла
+    uint64_t size;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    AssetPackType type;
+    uint32_t width, height;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(AssetPackHeader) == 16, "заголовок пака - 16 байт");
+static_assert(sizeof(AssetPackEntry) == 40, "запись пака - 40 байт");
+
+// Ссылка на содержимое внутри отображения; живёт, пока открыт пак
+struct AssetView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    uint32_t width = 0, height = 0; // для картинок
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+class AssetPack {
+public:
+    static constexpr char magic[4] = { 'D', 'I', 'O', 'D' };
+    static constexpr uint32_t version = 1;
+    static constexpr uint64_t alignment = 16;
+
+    AssetPack() = default;
+    ~AssetPack() { close(); }
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const char* path) {
+        close();
+        if (!map(path)) return false;
+        if (mappedSize < sizeof(AssetPackHeader) || !valid()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    size_t size() const { return isOpen() ? header()->entryCount : 0; }
+
+    // "./assets/textures/x.png", "assets\\textures\\x.png" и "textures/x.png" - одно и то же имя
+    static std::string normalize(const std::string& path) {
+        std::string name = path;
+        std::replace(name.begin(), name.end(), '\\', '/');
+        while (name.compare(0, 2, "./") == 0) name.erase(0, 2);
+        if (name.compare(0, 7, "assets/") == 0) name.erase(0, 7);
+        return name;
+    }
+
+    // Двоичный поиск по отсортированному оглавлению
+    const AssetPackEntry* find(const std::string& path) const {
+        if (!isOpen()) return nullptr;
+        const std::string name = normalize(path);
+        const AssetPackEntry* first = entries();
+        const AssetPackEntry* last = first + header()->entryCount;
+        const AssetPackEntry* it = std::lower_bound(first, last, name, [this](const AssetPackEntry& e, const std::string& n) {
+            return compare(e, n) < 0;
+        });
+        return it != last && compare(*it, name) == 0 ? it : nullptr;
+    }
+
+    bool contains(const std::string& path) const { return find(path) != nullptr; }
+
+    AssetView view(const std::string& path) const {
+        const AssetPackEntry* e = find(path);
+        if (!e) return {};
+        return AssetView{ base + e->offset, static_cast<size_t>(e->size), e->width, e->height };
+    }
+
+    // Раскодированная картинка; пусто, если записи нет или это не картинка
+    AssetView image(const std::string& path) const {
+        const AssetPackEntry* e = find(path);
+        if (!e || e->type != AssetPackType::Image) return {};
+        return AssetView{ base + e->offset, static_cast<size_t>(e->size), e->width, e->height };
+    }
+
+    // Текстура прямо из отображения - без чтения файла и декодирования
+    bool texture(const std::string& path, tgui::Texture& out, const tgui::UIntRect& part = {}) const {
+        const AssetView pixels = image(path);
+        if (!pixels) return false;
+        out.loadFromPixelData({ pixels.width, pixels.height }, pixels.data, part);
+        return true;
+    }
+
+    // Шрифт из байтов пака (TGUI держит свою копию - файл шрифта не открывается)
+    bool font(const std::string& path, tgui::Font& out) const {
+        const AssetView bytes = view(path);
+        if (!bytes) return false;
+        out = tgui::Font(bytes.data, bytes.size);
+        return true;
+    }
+
+    // Имя записи i (для отчётов и инструментов)
+    std::string name(size_t i) const {
+        const AssetPackEntry& e = entries()[i];
+        return std::string(reinterpret_cast<const char*>(base + e.nameOffset), e.nameLength);
+    }
+
+    const AssetPackEntry& entry(size_t i) const { return entries()[i]; }
+
+    void close() {
+        if (!base) return;
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(const_cast<uint8_t*>(base), mappedSize);
+#endif
+        base = nullptr;
+        mappedSize = 0;
+    }
+
+private:
+    const AssetPackHeader* header() const { return reinterpret_cast<const AssetPackHeader*>(base); }
+    const AssetPackEntry* entries() const { return reinterpret_cast<const AssetPackEntry*>(base + sizeof(AssetPackHeader)); }
+
+    int compare(const AssetPackEntry& e, const std::string& n) const {
+        const size_t common = std::min<size_t>(e.nameLength, n.size());
+        const int c = std::memcmp(base + e.nameOffset, n.data(), common);
+        if (c != 0) return c;
+        return e.nameLength < n.size() ? -1 : (e.nameLength > n.size() ? 1 : 0);
+    }
+
+    // Повреждённый или чужой файл не должен дать чтение за пределами отображения
+    bool valid() const {
+        const AssetPackHeader* h = header();
+        if (std::memcmp(h->magic, magic, 4) != 0 || h->version != version) return false;
+        const uint64_t tableEnd = sizeof(AssetPackHeader) + static_cast<uint64_t>(h->entryCount) * sizeof(AssetPackEntry);
+        if (tableEnd > mappedSize) return false;
+        for (uint32_t i = 0; i < h->entryCount; ++i) {
+            const AssetPackEntry& e = entries()[i];
+            if (static_cast<uint64_t>(e.nameOffset) + e.nameLength > mappedSize) return false;
+            if (e.offset > mappedSize || e.size > mappedSize - e.offset) return false;
+            if (e.type == AssetPackType::Image && static_cast<uint64_t>(e.width) * e.height * 4 != e.size) return false;
+        }
+        return true;
+    }
+
+    bool map(const char* path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        CloseHandle(file);
+        if (!mapping) return false;
+        base = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping); // отображение держит объект само
+        mappedSize = base ? static_cast<size_t>(fileSize.QuadPart) : 0;
+        return base != nullptr;
+#else
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = static_cast<const uint8_t*>(p);
+        mappedSize = static_cast<size_t>(st.st_size);
+        return true;
+#endif
+    }
+
+    const uint8_t* base = nullptr;
+    size_t mappedSize = 0;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Ограниченное lock-free кольцо "много писателей - один читатель" (ячейки с номерами последовательности).
+// Писатели занимают позицию через CAS на хвосте, читатель забирает без атомарных RMW.
+// Переполнение не блокирует: tryPush возвращает false, решать вызывающему.
+template <class T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ёмкость - степень двойки");
+
+public:
+    MpscQueue() : cells(new Cell[Capacity]) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Любой поток
+    bool tryPush(T&& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // заполнено
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Только поток-читатель
+    bool tryPop(T& out) {
+        Cell& cell = cells[head & mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != head + 1) {
+            return false; // пусто или писатель ещё не дописал ячейку
+        }
+        out = std::move(cell.value);
+        cell.value = T{};
+        cell.sequence.store(head + Capacity, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) size_t head = 0;
+};
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef DICE_KERNEL_H
+#define DICE_KERNEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "random_system.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define DICE_KERNEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DICE_KERNEL_TARGET_SSE2
+#define DICE_KERNEL_TARGET_AVX2
+#else
+#define DICE_KERNEL_TARGET_SSE2 __attribute__((target("sse2")))
+#define DICE_KERNEL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Исходы раунда, в том же порядке, что и who_win_mass
+enum class RoundOutcome : uint8_t {
+    Pl1Win = 0,
+    Pl2Win = 1,
+    Draw = 2
+};
+
+// Пакет раундов в виде столбцов: кубики игроков лежат в четырёх строках по capacity элементов,
+// исход раунда i - один байт outcomes[i] (индекс в who_win_mass)
+struct DiceBatch {
+    static constexpr size_t capacity = 4096;
+
+    enum Row { Pl1Cube1 = 0, Pl1Cube2 = 1, Pl2Cube1 = 2, Pl2Cube2 = 3 };
+
+    alignas(32) uint16_t words[4 * capacity];
+    alignas(32) uint8_t faces[4 * capacity];
+    alignas(32) uint8_t outcomes[capacity];
+    size_t rounds = 0;
+
+    uint8_t face(Row row, size_t round) const { return faces[row * capacity + round]; }
+};
+
+class DiceKernel {
+public:
+    enum class Path {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // Лучший путь для текущего процессора, определяется один раз
+    static Path bestPath() {
+        static const Path path = detectPath();
+        return path;
+    }
+
+    static const char* pathName(Path path) {
+        switch (path) {
+            case Path::SSE2: return "sse2";
+            case Path::AVX2: return "avx2";
+            default: return "scalar";
+        }
+    }
+
+    // Бросает 4 кубика на rounds раундов (rounds <= capacity) и раскладывает исходы по байтам.
+    // Результат одинаков для любого path при одном и том же состоянии rng.
+    static void play(FastRandom& rng, DiceBatch& batch, size_t rounds, Path path = bestPath()) {
+        if (rounds > DiceBatch::capacity) rounds = DiceBatch::capacity;
+        batch.rounds = rounds;
+
+        for (size_t row = 0; row < 4; ++row) {
+            fillWords(rng, batch.words + row * DiceBatch::capacity, rounds);
+        }
+        for (size_t row = 0; row < 4; ++row) {
+            const size_t offset = row * DiceBatch::capacity;
+            facesFromWords(rng, batch.words + offset, batch.faces + offset, rounds, path);
+        }
+        resolve(batch.faces, batch.faces + DiceBatch::capacity,
+                batch.faces + 2 * DiceBatch::capacity, batch.faces + 3 * DiceBatch::capacity,
+                batch.outcomes, rounds, path);
+    }
+
+    // То же на генераторе текущего потока, как randsh()
+    static void play(DiceBatch& batch, size_t rounds) {
+        play(RandomSystem::local(), batch, rounds);
+    }
+
+    // 16-битные случайные слова -> грани 1..6 без смещения: face = (w * 6) >> 16,
+    // слова с младшей половиной произведения < 65536 % 6 перебрасываются через rng
+    static void facesFromWords(FastRandom& rng, const uint16_t* words, uint8_t* faces, size_t count,
+                               Path path = bestPath()) {
+        size_t done = 0;
+#ifdef DICE_KERNEL_X86
+        if (path == Path::AVX2) done = facesAvx2(rng, words, faces, count);
+        else if (path == Path::SSE2) done = facesSse2(rng, words, faces, count);
+#else
+        (void)path;
+#endif
+        for (size_t i = done; i < count; ++i) {
+            faces[i] = faceFromWord(rng, words[i]);
+        }
+    }
+
+    // Суммы 2d6 -> коды исходов (0 - pl1 win, 1 - pl2 win, 2 - draw)
+    static void resolve(const uint8_t* a1, const uint8_t* a2, const uint8_t* b1, const uint8_t* b2,
+                        uint8_t* outcomes, size_t count, Path path = bestPath()) {
+        size_t done = 0;
+#ifdef DICE_KERNEL_X86
+        if (path == Path::AVX2) done = resolveAvx2(a1, a2, b1, b2, outcomes, count);
+        else if (path == Path::SSE2) done = resolveSse2(a1, a2, b1, b2, outcomes, count);
+#else
+        (void)path;
+#endif
+        for (size_t i = done; i < count; ++i) {
+            const int sum1 = a1[i] + a2[i];
+            const int sum2 = b1[i] + b2[i];
+            outcomes[i] = static_cast<uint8_t>(sum1 > sum2 ? RoundOutcome::Pl1Win
+                                             : sum1 < sum2 ? RoundOutcome::Pl2Win
+                                                           : RoundOutcome::Draw);
+        }
+    }
+
+private:
+    static constexpr uint32_t faceCount = 6;
+    static constexpr uint32_t rejectBelow = 65536 % faceCount;
+
+    static void fillWords(FastRandom& rng, uint16_t* words, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const uint64_t word = rng.nextU64();
+            std::memcpy(words + i, &word, sizeof(word));
+        }
+        if (i < count) {
+            const uint64_t word = rng.nextU64();
+            std::memcpy(words + i, &word, (count - i) * sizeof(uint16_t));
+        }
+    }
+
+    static uint8_t faceFromWord(FastRandom& rng, uint16_t word) {
+        const uint32_t m = uint32_t(word) * faceCount;
+        if ((m & 0xFFFF) < rejectBelow) {
+            return static_cast<uint8_t>(1 + rng.bounded(faceCount));
+        }
+        return static_cast<uint8_t>(1 + (m >> 16));
+    }
+
+    static Path detectPath() {
+#ifdef DICE_KERNEL_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;
+        const bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+        bool avx2 = false;
+        if (osAvx && maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse2 = __builtin_cpu_supports("sse2");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2) return Path::AVX2;
+        if (sse2) return Path::SSE2;
+#endif
+        return Path::Scalar;
+    }
+
+#ifdef DICE_KERNEL_X86
+    // Перебрасывает отбракованные дорожки блока по возрастанию индекса, как скалярный путь
+    static void fixupLanes(FastRandom& rng, uint8_t* faces, uint32_t laneMask) {
+        while (laneMask) {
+            unsigned lane = 0;
+            while (!(laneMask & (1u << lane))) ++lane;
+            faces[lane] = static_cast<uint8_t>(1 + rng.bounded(faceCount));
+            laneMask &= laneMask - 1;
+        }
+    }
+
+    DICE_KERNEL_TARGET_SSE2
+    static size_t facesSse2(FastRandom& rng, const uint16_t* words, uint8_t* faces, size_t count) {
+        const __m128i six = _mm_set1_epi16(faceCount);
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m128i w0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+            const __m128i w1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i + 8));
+
+            const __m128i f0 = _mm_add_epi16(_mm_mulhi_epu16(w0, six), one);
+            const __m128i f1 = _mm_add_epi16(_mm_mulhi_epu16(w1, six), one);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(faces + i), _mm_packus_epi16(f0, f1));
+
+            // младшая половина < 4 <=> (low >> 2) == 0
+            const __m128i r0 = _mm_cmpeq_epi16(_mm_srli_epi16(_mm_mullo_epi16(w0, six), 2), zero);
+            const __m128i r1 = _mm_cmpeq_epi16(_mm_srli_epi16(_mm_mullo_epi16(w1, six), 2), zero);
+            const uint32_t reject = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(r0, r1)));
+            if (reject) {
+                fixupLanes(rng, faces + i, reject);
+            }
+        }
+        return i;
+    }
+
+    DICE_KERNEL_TARGET_AVX2
+    static size_t facesAvx2(FastRandom& rng, const uint16_t* words, uint8_t* faces, size_t count) {
+        const __m256i six = _mm256_set1_epi16(faceCount);
+        const __m256i one = _mm256_set1_epi16(1);
+        const __m256i zero = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            const __m256i w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+            const __m256i w1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i + 16));
+
+            const __m256i f0 = _mm256_add_epi16(_mm256_mulhi_epu16(w0, six), one);
+            const __m256i f1 = _mm256_add_epi16(_mm256_mulhi_epu16(w1, six), one);
+            // packus работает внутри 128-битных половин - возвращаем порядок перестановкой
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(f0, f1), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(faces + i), packed);
+
+            const __m256i r0 = _mm256_cmpeq_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(w0, six), 2), zero);
+            const __m256i r1 = _mm256_cmpeq_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(w1, six), 2), zero);
+            const __m256i rejectBytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(r0, r1), 0xD8);
+            const uint32_t reject = static_cast<uint32_t>(_mm256_movemask_epi8(rejectBytes));
+            if (reject) {
+                fixupLanes(rng, faces + i, reject);
+            }
+        }
+        return i;
+    }
+
+    DICE_KERNEL_TARGET_SSE2
+    static size_t resolveSse2(const uint8_t* a1, const uint8_t* a2, const uint8_t* b1, const uint8_t* b2,
+                              uint8_t* outcomes, size_t count) {
+        const __m128i draw = _mm_set1_epi8(static_cast<char>(RoundOutcome::Draw));
+        const __m128i two = _mm_set1_epi8(2);
+        const __m128i one = _mm_set1_epi8(1);
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m128i sum1 = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a1 + i)),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(a2 + i)));
+            const __m128i sum2 = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b1 + i)),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(b2 + i)));
+            // draw(2) - 2 если pl1 больше, - 1 если меньше
+            const __m128i gt = _mm_and_si128(_mm_cmpgt_epi8(sum1, sum2), two);
+            const __m128i lt = _mm_and_si128(_mm_cmpgt_epi8(sum2, sum1), one);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outcomes + i),
+                             _mm_sub_epi8(_mm_sub_epi8(draw, gt), lt));
+        }
+        return i;
+    }
+
+    DICE_KERNEL_TARGET_AVX2
+    static size_t resolveAvx2(const uint8_t* a1, const uint8_t* a2, const uint8_t* b1, const uint8_t* b2,
+                              uint8_t* outcomes, size_t count) {
+        const __m256i draw = _mm256_set1_epi8(static_cast<char>(RoundOutcome::Draw));
+        const __m256i two = _mm256_set1_epi8(2);
+        const __m256i one = _mm256_set1_epi8(1);
+
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            const __m256i sum1 = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a1 + i)),
+                                                 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a2 + i)));
+            const __m256i sum2 = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b1 + i)),
+                                                 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b2 + i)));
+            const __m256i gt = _mm256_and_si256(_mm256_cmpgt_epi8(sum1, sum2), two);
+            const __m256i lt = _mm256_and_si256(_mm256_cmpgt_epi8(sum2, sum1), one);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(outcomes + i),
+                                _mm256_sub_epi8(_mm256_sub_epi8(draw, gt), lt));
+        }
+        return i;
+    }
+#endif
+};
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef DICE_PHYSICS_H
+#define DICE_PHYSICS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "random_system.h"
+
+// Кубики, высыпанные из стакана: 2D-физика с фиксированным шагом - стенки стола, удары кубиков друг о друга,
+// затухание и засыпание. Кубик - круг радиуса radius; верхняя грань меняется, когда кубик прокатился на ребро
+// (перекат на соседнюю грань, как у настоящего кубика). Всё в пикселях исходной сцены (scene_layout.h).
+//
+// Результат раунда задаёт GameCore, а не физика: steer() прогоняет копию мира до остановки и перенумеровывает
+// грани каждого кубика поворотом куба так, чтобы он лёг нужной гранью. При одном seed и одной сборке мир
+// детерминирован (шаг - только + - * / sqrt в фиксированном порядке), поэтому показ совпадает с прогоном.
+// Память - массивы фиксированного размера, без кучи: копия мира для steer() лежит на стеке.
+
+// Прямоугольник стола, в который высыпаются кубики
+struct DiceTable {
+    float left, top, right, bottom;
+};
+
+// Параметры броска из одного стакана
+struct DiceThrow {
+    float x = 0, y = 0;          // центр стакана
+    float direction = 0;         // радианы: 0 - вправо, pi/2 - вниз
+    float spread = 0.6f;         // ширина конуса вокруг direction
+    float speedMin = 250, speedMax = 450;
+    float spinMax = 12;          // радиан/с в обе стороны
+    float scatter = 20;          // разброс стартовых позиций вокруг центра
+};
+
+class DicePhysics {
+public:
+    static constexpr size_t maxDice = 32;
+    static constexpr float stepSeconds = 1.0f / 120;
+    static constexpr unsigned maxStepsPerAdvance = 30; // после долгого кадра мир догоняет не больше 0.25 с
+    static constexpr unsigned maxSimulationSteps = 120 * 8; // дольше 8 с кубики не катятся - засыпают принудительно
+
+    float radius = 16;
+    float restitution = 0.5f;      // удар кубиков друг о друга
+    float wallRestitution = 0.45f; // удар о борт
+    float linearDamping = 1.6f;    // доля скорости, теряемая за секунду
+    float angularDamping = 2.5f;
+    float sleepSpeed = 6;          // пикселей/с
+    float sleepSpin = 0.4f;        // радиан/с
+    unsigned sleepSteps = 20;      // столько шагов подряд медленнее порога - кубик засыпает
+
+    void reset(const DiceTable& bounds) {
+        table = bounds;
+        count = 0;
+        steps = 0;
+        accumulator = 0;
+    }
+
+    // Кубик со случайной ориентацией; false - мир полон
+    bool add(float x, float y, float vx, float vy, float spin, FastRandom& rng) {
+        if (count == maxDice) return false;
+        const size_t i = count++;
+        px[i] = x;
+        py[i] = y;
+        pvx[i] = vx;
+        pvy[i] = vy;
+        pangle[i] = 0;
+        pspin[i] = spin;
+        rollX[i] = 0;
+        rollY[i] = 0;
+        restSteps[i] = 0;
+
+        top[i] = static_cast<uint8_t>(1 + rng.bounded(6));
+        uint8_t sides[4];
+        size_t n = 0;
+        for (uint8_t face = 1; face <= 6; ++face) {
+            if (face != top[i] && face != 7 - top[i]) sides[n++] = face;
+        }
+        north[i] = sides[rng.bounded(4)];
+        east[i] = eastOf(top[i], north[i]);
+        for (uint8_t face = 0; face <= 6; ++face) labels[i][face] = face;
+        return true;
+    }
+
+    // count кубиков из стакана: все случайные числа берутся из rng, тот же seed - тот же бросок
+    size_t throwDice(const DiceThrow& t, size_t dice, FastRandom& rng) {
+        size_t added = 0;
+        for (; added < dice; ++added) {
+            const float direction = t.direction + t.spread * (rng.nextFloat() - 0.5f);
+            const float speed = rng.uniformFloat(t.speedMin, t.speedMax);
+            const float x = t.x + rng.uniformFloat(-t.scatter, t.scatter);
+            const float y = t.y + rng.uniformFloat(-t.scatter, t.scatter);
+            const float spin = rng.uniformFloat(-t.spinMax, t.spinMax);
+            if (!add(x, y, std::cos(direction) * speed, std::sin(direction) * speed, spin, rng)) break;
+        }
+        return added;
+    }
+
+    // Один шаг stepSeconds; false - все кубики спят
+    bool step() {
+        const float dt = stepSeconds;
+        const float linear = std::max(0.0f, 1.0f - linearDamping * dt);
+        const float angular = std::max(0.0f, 1.0f - angularDamping * dt);
+        const bool forceSleep = ++steps >= maxSimulationSteps;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (asleep(i)) continue;
+            pvx[i] *= linear;
+            pvy[i] *= linear;
+            pspin[i] *= angular;
+            px[i] += pvx[i] * dt;
+            py[i] += pvy[i] * dt;
+            pangle[i] += pspin[i] * dt;
+            roll(i, pvx[i] * dt, pvy[i] * dt);
+            collideWalls(i);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = i + 1; j < count; ++j) collidePair(i, j);
+        }
+
+        bool moving = false;
+        for (size_t i = 0; i < count; ++i) {
+            if (asleep(i)) continue;
+            const bool slow = pvx[i] * pvx[i] + pvy[i] * pvy[i] < sleepSpeed * sleepSpeed && std::fabs(pspin[i]) < sleepSpin;
+            restSteps[i] = slow ? restSteps[i] + 1 : 0;
+            if (forceSleep || restSteps[i] >= sleepSteps) {
+                restSteps[i] = sleepSteps;
+                pvx[i] = pvy[i] = pspin[i] = 0;
+            } else {
+                moving = true;
+            }
+        }
+        return moving;
+    }
+
+    // Из кадра: накопленное время отрабатывается целыми шагами; возвращает число шагов
+    unsigned advance(double seconds) {
+        accumulator += seconds;
+        unsigned done = 0;
+        while (accumulator >= stepSeconds && done < maxStepsPerAdvance) {
+            accumulator -= stepSeconds;
+            ++done;
+            if (!step()) {
+                accumulator = 0;
+                break;
+            }
+        }
+        if (done == maxStepsPerAdvance) accumulator = 0;
+        return done;
+    }
+
+    // Шагать до остановки всех кубиков; возвращает число шагов
+    unsigned runToRest() {
+        unsigned done = 1;
+        while (step()) ++done;
+        return done;
+    }
+
+    // Перенумеровать грани так, чтобы после прогона до остановки кубик i лёг гранью wanted[i] (1..6, иначе как выпадет).
+    // Зовётся сразу после броска, до первого шага: мир копируется и прогоняется до конца
+    void steer(const uint8_t* wanted, size_t dice) {
+        DicePhysics preview = *this;
+        preview.runToRest();
+        for (size_t i = 0; i < std::min(dice, count); ++i) {
+            if (wanted[i] >= 1 && wanted[i] <= 6) relabel(i, preview.top[i], wanted[i]);
+        }
+    }
+
+    size_t size() const { return count; }
+    bool busy() const {
+        for (size_t i = 0; i < count; ++i) {
+            if (!asleep(i)) return true;
+        }
+        return false;
+    }
+
+    float x(size_t i) const { return px[i]; }
+    float y(size_t i) const { return py[i]; }
+    float angle(size_t i) const { return pangle[i]; } // радианы, по часовой (ось y вниз)
+
+    // Грань, которую видно сверху, с учётом steer()
+    uint8_t face(size_t i) const { return labels[i][top[i]]; }
+
+private:
+    bool asleep(size_t i) const { return restSteps[i] >= sleepSteps; }
+
+    // Грани как оси: 1 - верх (+z), 2 - север (+y), 3 - восток (+x), противоположные в сумме 7
+    static void axis(uint8_t face, int v[3]) {
+        static const int axes[7][3] = { { 0, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 }, { 1, 0, 0 },
+                                        { -1, 0, 0 }, { 0, -1, 0 }, { 0, 0, -1 } };
+        v[0] = axes[face][0];
+        v[1] = axes[face][1];
+        v[2] = axes[face][2];
+    }
+
+    // Восточная грань по верхней и северной: east = north x top
+    static uint8_t eastOf(uint8_t topFace, uint8_t northFace) {
+        int t[3], n[3];
+        axis(topFace, t);
+        axis(northFace, n);
+        const int e[3] = { n[1] * t[2] - n[2] * t[1], n[2] * t[0] - n[0] * t[2], n[0] * t[1] - n[1] * t[0] };
+        for (uint8_t face = 1; face <= 6; ++face) {
+            int f[3];
+            axis(face, f);
+            if (f[0] == e[0] && f[1] == e[1] && f[2] == e[2]) return face;
+        }
+        return 0;
+    }
+
+    // Прокатился на ребро - перекат на соседнюю грань (y экрана растёт вниз, север - вверх)
+    void roll(size_t i, float dx, float dy) {
+        const float edge = 2 * radius;
+        rollX[i] += dx;
+        rollY[i] += dy;
+        while (rollX[i] >= edge) {
+            rollX[i] -= edge;
+            const uint8_t t = top[i];
+            top[i] = static_cast<uint8_t>(7 - east[i]);
+            east[i] = t;
+        }
+        while (rollX[i] <= -edge) {
+            rollX[i] += edge;
+            const uint8_t t = top[i];
+            top[i] = east[i];
+            east[i] = static_cast<uint8_t>(7 - t);
+        }
+        while (rollY[i] >= edge) {
+            rollY[i] -= edge;
+            const uint8_t t = top[i];
+            top[i] = north[i];
+            north[i] = static_cast<uint8_t>(7 - t);
+        }
+        while (rollY[i] <= -edge) {
+            rollY[i] += edge;
+            const uint8_t t = top[i];
+            top[i] = static_cast<uint8_t>(7 - north[i]);
+            north[i] = t;
+        }
+    }
+
+    // Только положение, без отскока: после расталкивания в collidePair
+    void clampToTable(size_t i) {
+        px[i] = std::clamp(px[i], table.left + radius, table.right - radius);
+        py[i] = std::clamp(py[i], table.top + radius, table.bottom - radius);
+    }
+
+    void collideWalls(size_t i) {
+        // Удар о борт закручивает кубик: касательная скорость переходит во вращение
+        if (px[i] - radius < table.left || px[i] + radius > table.right) {
+            px[i] = std::clamp(px[i], table.left + radius, table.right - radius);
+            pvx[i] = -pvx[i] * wallRestitution;
+            pspin[i] += pvy[i] * (px[i] < (table.left + table.right) / 2 ? -0.5f : 0.5f) / radius;
+        }
+        if (py[i] - radius < table.top || py[i] + radius > table.bottom) {
+            py[i] = std::clamp(py[i], table.top + radius, table.bottom - radius);
+            pvy[i] = -pvy[i] * wallRestitution;
+            pspin[i] += pvx[i] * (py[i] < (table.top + table.bottom) / 2 ? 0.5f : -0.5f) / radius;
+        }
+    }
+
+    // Равные массы: раздвинуть наполовину каждый, импульс по нормали; спящий кубик от удара просыпается
+    void collidePair(size_t i, size_t j) {
+        const float dx = px[j] - px[i];
+        const float dy = py[j] - py[i];
+        const float minDistance = 2 * radius;
+        const float distance2 = dx * dx + dy * dy;
+        if (distance2 >= minDistance * minDistance) return;
+
+        const float distance = std::sqrt(distance2);
+        const float nx = distance > 0 ? dx / distance : 1.0f;
+        const float ny = distance > 0 ? dy / distance : 0.0f;
+        const float push = (minDistance - distance) / 2;
+        px[i] -= nx * push;
+        py[i] -= ny * push;
+        px[j] += nx * push;
+        py[j] += ny * push;
+        // Спящий кубик стенки не проверяет - иначе сосед вытолкнул бы его за край стола
+        clampToTable(i);
+        clampToTable(j);
+
+        const float approach = (pvx[j] - pvx[i]) * nx + (pvy[j] - pvy[i]) * ny;
+        if (approach >= 0) return;
+        const float impulse = -(1 + restitution) * approach / 2;
+        pvx[i] -= impulse * nx;
+        pvy[i] -= impulse * ny;
+        pvx[j] += impulse * nx;
+        pvy[j] += impulse * ny;
+
+        // Скользящий удар закручивает оба кубика в разные стороны
+        const float tangent = ((pvx[j] - pvx[i]) * -ny + (pvy[j] - pvy[i]) * nx) / minDistance;
+        pspin[i] -= tangent * 0.5f;
+        pspin[j] += tangent * 0.5f;
+
+        if (std::fabs(approach) > sleepSpeed) {
+            restSteps[i] = 0;
+            restSteps[j] = 0;
+        }
+    }
+
+    // Поворот куба как перенумерация граней: показанная грань кубика, легшего физической гранью landed, становится wanted.
+    // Соседние грани остаются соседними - перекаты по дороге выглядят как у настоящего кубика
+    void relabel(size_t i, uint8_t landed, uint8_t wanted) {
+        const uint8_t from = labels[i][landed];
+        const uint8_t oppositeFrom = static_cast<uint8_t>(7 - from);
+        uint8_t rotation[7] = { 0, 1, 2, 3, 4, 5, 6 };
+        if (wanted == oppositeFrom) {
+            // 180 градусов вокруг оси через боковую грань: меняются местами пара from и вторая боковая пара
+            const uint8_t side = from == 1 || from == 6 ? 3 : 1;
+            rotation[from] = oppositeFrom;
+            rotation[oppositeFrom] = from;
+            rotation[side] = static_cast<uint8_t>(7 - side);
+            rotation[7 - side] = side;
+        } else if (wanted != from) {
+            // 90 градусов вокруг оставшейся оси: from -> wanted -> низ -> противоположная wanted -> from
+            rotation[from] = wanted;
+            rotation[wanted] = oppositeFrom;
+            rotation[oppositeFrom] = static_cast<uint8_t>(7 - wanted);
+            rotation[7 - wanted] = from;
+        }
+        for (uint8_t& label : labels[i]) label = rotation[label];
+    }
+
+    DiceTable table{ 0, 0, 0, 0 };
+    size_t count = 0;
+    unsigned steps = 0;
+    double accumulator = 0;
+
+    std::array<float, maxDice> px{}, py{}, pvx{}, pvy{}, pangle{}, pspin{}, rollX{}, rollY{};
+    std::array<unsigned, maxDice> restSteps{};
+    std::array<uint8_t, maxDice> top{}, north{}, east{};
+    std::array<std::array<uint8_t, 7>, maxDice> labels{};
+};
+
+#endif
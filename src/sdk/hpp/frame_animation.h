@@ -0,0 +1,251 @@
+#ifndef FRAME_ANIMATION_H
+#define FRAME_ANIMATION_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "inline_function.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+
+// Покадровая анимация спрайтов (взвод курка, выстрел): кадр клипа - прямоугольник на странице атласа,
+// смена кадра меняет только UV спрайта в SpriteBatch - ни загрузки, ни переключения текстуры.
+// Кадры одного клипа pack_atlas кладёт на одну страницу (--clips).
+//
+// Описание клипов (assets/animations/clips.txt, # - комментарий):
+//   clip <имя> [loop]
+//   frame <секунды> <событие или -> <спрайт атласа до конца строки>
+// Событие приходит в callback play(), когда кадр показан; у незацикленного клипа в конце - "end".
+
+// Клип как в файле - имена спрайтов; нужен и атласу (группы страниц), и аниматору
+struct FrameClipSource {
+    struct Frame {
+        float duration;
+        std::string event;
+        std::string sprite;
+    };
+
+    std::string name;
+    bool loop = false;
+    std::vector<Frame> frames;
+
+    static bool parse(const char* text, size_t size, std::vector<FrameClipSource>& out) {
+        out.clear();
+        std::string line;
+        for (size_t begin = 0; begin < size;) {
+            size_t end = begin;
+            while (end < size && text[end] != '\n') ++end;
+            line.assign(text + begin, end - begin);
+            begin = end + 1;
+
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+
+            char name[64];
+            char loop[8] = {};
+            float duration;
+            int spriteStart = 0;
+            if (std::sscanf(line.c_str(), " clip %63s %7s", name, loop) >= 1) {
+                FrameClipSource clip;
+                clip.name = name;
+                clip.loop = std::string(loop) == "loop";
+                out.push_back(clip);
+            } else if (std::sscanf(line.c_str(), " frame %f %63s %n", &duration, name, &spriteStart) == 2 && spriteStart > 0) {
+                if (out.empty() || duration <= 0) return false;
+                const std::string event = name;
+                out.back().frames.push_back(Frame{ duration, event == "-" ? std::string() : event,
+                                                   line.substr(static_cast<size_t>(spriteStart)) });
+            }
+        }
+        for (const FrameClipSource& clip : out) {
+            if (clip.frames.empty()) return false;
+        }
+        return !out.empty();
+    }
+
+    static bool load(const std::string& path, std::vector<FrameClipSource>& out) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        std::string text;
+        char chunk[4096];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) text.append(chunk, read);
+        std::fclose(file);
+        return parse(text.data(), text.size(), out);
+    }
+};
+
+// Клип, привязанный к атласу: кадры - прямоугольники одной страницы
+struct FrameClip {
+    struct Frame {
+        tgui::UIntRect rect;
+        float duration;
+        std::string event;
+    };
+
+    std::string name;
+    unsigned page = 0;
+    bool loop = false;
+    double length = 0;
+    std::vector<Frame> frames;
+};
+
+using FrameEvent = InlineFunction<void(const std::string& event)>;
+
+class FrameAnimator {
+public:
+    explicit FrameAnimator(SpriteBatch& spriteBatch) : batch(spriteBatch) {}
+
+    FrameAnimator(const FrameAnimator&) = delete;
+    FrameAnimator& operator=(const FrameAnimator&) = delete;
+
+    // Клипы, у которых нет кадра в атласе или кадры на разных страницах, пропускаются
+    size_t setClips(const std::vector<FrameClipSource>& sources, const TextureAtlas& atlas) {
+        playbacks.clear();
+        clips.clear();
+        for (const FrameClipSource& source : sources) {
+            FrameClip clip;
+            clip.name = source.name;
+            clip.loop = source.loop;
+            bool usable = true;
+            for (const FrameClipSource::Frame& frame : source.frames) {
+                const AtlasRegion* r = atlas.region(frame.sprite);
+                if (!r || (!clip.frames.empty() && r->page != clip.page)) {
+                    usable = false;
+                    break;
+                }
+                clip.page = r->page;
+                clip.frames.push_back(FrameClip::Frame{ tgui::UIntRect(r->x, r->y, r->width, r->height), frame.duration, frame.event });
+                clip.length += frame.duration;
+            }
+            if (usable) clips.push_back(std::move(clip));
+        }
+        return clips.size();
+    }
+
+    const FrameClip* clip(const std::string& name) const {
+        for (const FrameClip& c : clips) {
+            if (c.name == name) return &c;
+        }
+        return nullptr;
+    }
+
+    size_t clipCount() const { return clips.size(); }
+
+    // Картинка спрайта должна быть со страницы клипа (любой её спрайт) - дальше меняется только UV.
+    // Уже играющий на спрайте клип заменяется; отсчёт начинается со следующего update()
+    bool play(SpriteBatch::Sprite sprite, const std::string& clipName, FrameEvent onEvent = nullptr) {
+        const FrameClip* c = clip(clipName);
+        if (!c) return false;
+
+        stop(sprite);
+        batch.setFrame(sprite, c->frames[0].rect);
+        Playback playback{ sprite, c, 0, -1.0, std::move(onEvent), false };
+        if (updating) incoming.push_back(std::move(playback));
+        else playbacks.push_back(std::move(playback));
+        return true;
+    }
+
+    // Спрайт остаётся на текущем кадре
+    void stop(SpriteBatch::Sprite sprite) {
+        for (Playback& p : playbacks) {
+            if (p.sprite == sprite) p.done = true;
+        }
+        for (Playback& p : incoming) {
+            if (p.sprite == sprite) p.done = true;
+        }
+        if (!updating) compact();
+    }
+
+    bool isPlaying(SpriteBatch::Sprite sprite) const {
+        for (const Playback& p : playbacks) {
+            if (p.sprite == sprite && !p.done) return true;
+        }
+        return false;
+    }
+
+    bool busy() const { return !playbacks.empty(); }
+
+    // Раз в кадр, время в секундах тех же часов, что у AnimationSystem. Кадры, пропущенные долгим кадром,
+    // проходятся по очереди - события не теряются (кроме целых пропущенных кругов зацикленного клипа)
+    void update(double now) {
+        updating = true;
+        for (size_t i = 0; i < playbacks.size(); ++i) {
+            Playback& p = playbacks[i];
+            if (p.done) continue;
+            const FrameClip& c = *p.clip;
+
+            if (p.frameStart < 0) {
+                p.frameStart = now;
+                fire(p, c.frames[0].event);
+                continue;
+            }
+
+            if (c.loop && now - p.frameStart > 2 * c.length) {
+                p.frameStart += std::floor((now - p.frameStart) / c.length - 1) * c.length;
+            }
+
+            while (!p.done && now - p.frameStart >= c.frames[p.frame].duration) {
+                p.frameStart += c.frames[p.frame].duration;
+                if (p.frame + 1 < c.frames.size()) {
+                    ++p.frame;
+                } else if (c.loop) {
+                    p.frame = 0;
+                } else {
+                    p.done = true;
+                    fire(p, endEvent());
+                    break;
+                }
+                batch.setFrame(p.sprite, c.frames[p.frame].rect);
+                fire(p, c.frames[p.frame].event);
+            }
+        }
+        updating = false;
+        compact();
+    }
+
+    static const std::string& endEvent() {
+        static const std::string end = "end";
+        return end;
+    }
+
+private:
+    struct Playback {
+        SpriteBatch::Sprite sprite;
+        const FrameClip* clip;
+        size_t frame;
+        double frameStart; // < 0 - ещё не начат
+        FrameEvent onEvent;
+        bool done;
+    };
+
+    static void fire(Playback& p, const std::string& event) {
+        if (!event.empty() && p.onEvent) p.onEvent(event);
+    }
+
+    void compact() {
+        size_t kept = 0;
+        for (size_t i = 0; i < playbacks.size(); ++i) {
+            if (playbacks[i].done) continue;
+            if (kept != i) playbacks[kept] = std::move(playbacks[i]);
+            ++kept;
+        }
+        playbacks.erase(playbacks.begin() + static_cast<std::ptrdiff_t>(kept), playbacks.end());
+        for (Playback& p : incoming) {
+            if (!p.done) playbacks.push_back(std::move(p));
+        }
+        incoming.clear();
+    }
+
+    SpriteBatch& batch;
+    std::vector<FrameClip> clips;
+    std::vector<Playback> playbacks;
+    std::vector<Playback> incoming; // запущенные из callback'ов во время update()
+    bool updating = false;
+};
+
+#endif
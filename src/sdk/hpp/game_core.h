@@ -0,0 +1,159 @@
+#ifndef GAME_CORE_H
+#define GAME_CORE_H
+
+#include <cstdint>
+
+#include "random_system.h"
+#include "dice_kernel.h"
+#include "match_rules.h"
+#include "odds_solver.h"
+
+// События раунда - битовые флаги, несколько за один шаг (победа + выстрел + конец матча)
+enum class GameEvent : uint8_t {
+    None = 0,
+    Pl1WonRound = 1 << 0,
+    Pl2WonRound = 1 << 1,
+    Draw = 1 << 2,
+    Pl1Fired = 1 << 3,  // pl1 стреляет в pl2
+    Pl2Fired = 1 << 4,  // pl2 стреляет в pl1
+    LiveRound = 1 << 5, // выстрел оказался боевым
+    MatchOver = 1 << 6
+};
+
+constexpr GameEvent operator|(GameEvent a, GameEvent b) {
+    return static_cast<GameEvent>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+}
+
+constexpr GameEvent& operator|=(GameEvent& a, GameEvent b) {
+    return a = a | b;
+}
+
+constexpr bool hasEvent(GameEvent events, GameEvent flag) {
+    return (static_cast<uint8_t>(events) & static_cast<uint8_t>(flag)) != 0;
+}
+
+enum class MatchWinner : uint8_t {
+    None,
+    Pl1,
+    Pl2
+};
+
+struct PlayerState {
+    short score = 0;          // очки (победы в раундах)
+    uint8_t progress = 0;     // победы с последнего выстрела
+    uint8_t shots = 0;        // сделано выстрелов из его револьвера
+    uint8_t liveChamber = 0;  // гнездо с боевым патроном
+    short cube1 = 0, cube2 = 0;
+
+    short cubes() const { return cube1 + cube2; }
+};
+
+// Всё состояние матча - простые данные без указателей и аллокаций
+struct GameState {
+    PlayerState pl1, pl2;
+    uint32_t round = 0;
+    RoundOutcome lastOutcome = RoundOutcome::Draw;
+    MatchWinner winner = MatchWinner::None;
+
+    bool over() const { return winner != MatchWinner::None; }
+};
+
+class GameCore {
+public:
+    // Новый матч: очки в ноль, револьверы заряжены заново
+    static void reset(GameState& state, FastRandom& rng) {
+        state = GameState{};
+        state.pl1.liveChamber = static_cast<uint8_t>(rng.bounded(MatchRules::revolverChambers));
+        state.pl2.liveChamber = static_cast<uint8_t>(rng.bounded(MatchRules::revolverChambers));
+    }
+
+    // Один раунд: бросок 2d6 каждому игроку и применение исхода. После конца матча кубики не бросаются -
+    // ни состояние, ни поток rng не меняются
+    static GameEvent step(GameState& state, FastRandom& rng) {
+        if (state.over()) return GameEvent::MatchOver;
+
+        short dice[4];
+        rng.rollDice(dice, 4);
+        state.pl1.cube1 = dice[0];
+        state.pl1.cube2 = dice[1];
+        state.pl2.cube1 = dice[2];
+        state.pl2.cube2 = dice[3];
+
+        const short sum1 = state.pl1.cubes();
+        const short sum2 = state.pl2.cubes();
+        const RoundOutcome outcome = sum1 > sum2 ? RoundOutcome::Pl1Win
+                                   : sum1 < sum2 ? RoundOutcome::Pl2Win
+                                                 : RoundOutcome::Draw;
+        return apply(state, outcome);
+    }
+
+    // Применяет готовый исход раунда (например, из пакета DiceKernel)
+    static GameEvent apply(GameState& state, RoundOutcome outcome) {
+        if (state.over()) return GameEvent::MatchOver;
+
+        ++state.round;
+        state.lastOutcome = outcome;
+
+        switch (outcome) {
+            case RoundOutcome::Pl1Win:
+                return GameEvent::Pl1WonRound | win(state, state.pl1, GameEvent::Pl1Fired, MatchWinner::Pl1);
+            case RoundOutcome::Pl2Win:
+                return GameEvent::Pl2WonRound | win(state, state.pl2, GameEvent::Pl2Fired, MatchWinner::Pl2);
+            default:
+                return GameEvent::Draw;
+        }
+    }
+
+    // Состояние для точных шансов OddsSolver (с точки зрения игрока - без знания гнезда)
+    static OddsState odds(const GameState& state) {
+        OddsState s;
+        s.pl1Progress = state.pl1.progress;
+        s.pl2Progress = state.pl2.progress;
+        s.pl1Shots = state.pl1.shots;
+        s.pl2Shots = state.pl2.shots;
+        return s;
+    }
+
+private:
+    static GameEvent win(GameState& state, PlayerState& winner, GameEvent fired, MatchWinner who) {
+        ++winner.score;
+        if (++winner.progress < MatchRules::winsPerShot) {
+            return GameEvent::None;
+        }
+
+        winner.progress = 0;
+        if (winner.shots++ != winner.liveChamber) {
+            return fired;
+        }
+
+        state.winner = who;
+        return fired | GameEvent::LiveRound | GameEvent::MatchOver;
+    }
+};
+
+// Матч со своим генератором - то, с чем работает интерфейс
+class Match {
+public:
+    explicit Match(uint64_t seed) : rng(seed) { GameCore::reset(state, rng); }
+    Match() : Match(RandomSystem::local().nextU64()) {}
+
+    // Следующий раунд; после конца матча сначала начинается новый
+    GameEvent play() {
+        if (state.over()) {
+            GameCore::reset(state, rng);
+        }
+        return GameCore::step(state, rng);
+    }
+
+    void restart() { GameCore::reset(state, rng); }
+
+    const GameState& current() const { return state; }
+
+    double pl1Odds() const { return OddsSolver::pl1Survives(GameCore::odds(state)); }
+
+private:
+    FastRandom rng;
+    GameState state;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef INLINE_FUNCTION_H
+#define INLINE_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <class Signature, size_t Capacity = 48>
+class InlineFunction;
+
+// Аналог std::function с буфером внутри объекта: callable хранится на месте и никогда не выделяет память.
+// Слишком большой callable - ошибка компиляции, а не тихая аллокация (большое состояние - держать по указателю).
+template <class R, class... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() = default;
+    InlineFunction(std::nullptr_t) {}
+
+    template <class F, class Fn = std::decay_t<F>,
+              class = std::enable_if_t<!std::is_same<Fn, InlineFunction>::value &&
+                                       std::is_invocable_r<R, Fn&, Args...>::value>>
+    InlineFunction(F&& f) {
+        static_assert(sizeof(Fn) <= Capacity, "callable не помещается в InlineFunction - увеличьте Capacity");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "слишком строгое выравнивание callable");
+        static_assert(std::is_copy_constructible<Fn>::value, "callable должен копироваться");
+
+        // Пустой указатель на функцию или пустой std::function - пустой InlineFunction
+        if constexpr (std::is_constructible<bool, const Fn&>::value) {
+            if (!static_cast<bool>(f)) return;
+        }
+        new (storage) Fn(std::forward<F>(f));
+        ops = &opsFor<Fn>;
+    }
+
+    InlineFunction(const InlineFunction& other) : ops(other.ops) {
+        if (ops) ops->copy(storage, other.storage);
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.reset();
+        }
+    }
+
+    InlineFunction& operator=(const InlineFunction& other) {
+        if (this != &other) {
+            InlineFunction copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                ops = other.ops;
+                ops->move(storage, other.storage);
+                other.reset();
+            }
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    ~InlineFunction() { reset(); }
+
+    R operator()(Args... args) const {
+        return ops->invoke(const_cast<unsigned char*>(storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void*, Args&&...);
+        void (*copy)(void*, const void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+    };
+
+    template <class Fn>
+    static constexpr Ops opsFor = {
+        [](void* self, Args&&... args) -> R { return (*static_cast<Fn*>(self))(std::forward<Args>(args)...); },
+        [](void* dst, const void* src) { new (dst) Fn(*static_cast<const Fn*>(src)); },
+        [](void* dst, void* src) { new (dst) Fn(std::move(*static_cast<Fn*>(src))); },
+        [](void* self) { static_cast<Fn*>(self)->~Fn(); }
+    };
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const Ops* ops = nullptr;
+};
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef LAYOUT_SYSTEM_H
+#define LAYOUT_SYSTEM_H
+
+#include <TGUI/TGUI.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "scene_layout.h"
+
+// Раскладка сцены из данных (assets/layouts/*.txt) с флагами изменений:
+// resize() только запоминает размер окна - сколько бы событий ни пришло за кадр, update() пересчитывает один раз
+// и трогает только виджеты, у которых действительно поменялись размер, позиция или размер текста.
+// Размер текста (целый) ставится лишь при изменении - иначе TGUI заново растеризует глифы.
+//
+// Формат файла (# - комментарий):
+//   scene <ширина> <высота>                          - исходный размер сцены
+//   place <имя> <x> <y> <ширина> <высота> [text <N>] - виджет в пикселях исходной сцены
+//   text <имя> <N>                                   - только размер текста (позицию задаёт сам виджет)
+class LayoutSystem {
+public:
+    bool load(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        std::string text;
+        char chunk[4096];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) text.append(chunk, read);
+        std::fclose(file);
+        return parse(text.data(), text.size());
+    }
+
+    // Привязки виджетов сохраняются, если имя осталось в новой таблице
+    bool parse(const char* text, size_t size) {
+        std::vector<Item> parsed;
+        float width = 0, height = 0;
+        std::string line;
+        for (size_t begin = 0; begin < size;) {
+            size_t end = begin;
+            while (end < size && text[end] != '\n') ++end;
+            line.assign(text + begin, end - begin);
+            begin = end + 1;
+
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+
+            char name[64];
+            Item item;
+            unsigned textSize = 0;
+            if (std::sscanf(line.c_str(), " scene %f %f", &width, &height) == 2) {
+                continue;
+            }
+            const int fields = std::sscanf(line.c_str(), " place %63s %f %f %f %f text %u", name, &item.rect.x, &item.rect.y,
+                                           &item.rect.width, &item.rect.height, &textSize);
+            if (fields >= 5) {
+                item.name = name;
+                item.placed = true;
+                item.baseTextSize = fields == 6 ? textSize : 0;
+                parsed.push_back(item);
+            } else if (std::sscanf(line.c_str(), " text %63s %u", name, &textSize) == 2) {
+                item.name = name;
+                item.baseTextSize = textSize;
+                parsed.push_back(item);
+            }
+        }
+        if (width <= 0 || height <= 0 || parsed.empty()) return false;
+
+        for (Item& item : parsed) {
+            if (const Item* old = find(item.name)) item.widget = old->widget;
+        }
+        sceneWidth = width;
+        sceneHeight = height;
+        items.swap(parsed);
+        markAllDirty();
+        return true;
+    }
+
+    // Встроенная раскладка стола (scene_layout.h) - если файла нет
+    void loadDefaults() {
+        static const char* names[SceneLayout::SlotCount] = {
+            "cup_pl1", "cup_pl2", "left_hand_pl1", "right_hand_pl1", "left_hand_pl2", "right_hand_pl2", "revolver", "muzzle_flash", "btn_tap"
+        };
+        std::vector<Item> defaults;
+        for (size_t i = 0; i < SceneLayout::SlotCount; ++i) {
+            Item item;
+            item.name = names[i];
+            item.rect = SceneLayout::positions[i];
+            item.placed = true;
+            item.baseTextSize = i == SceneLayout::BtnTap ? 28 : 0;
+            defaults.push_back(item);
+        }
+        for (const char* label : { "score_pl1", "score_pl2" }) {
+            Item item;
+            item.name = label;
+            item.baseTextSize = 16;
+            defaults.push_back(item);
+        }
+        for (Item& item : defaults) {
+            if (const Item* old = find(item.name)) item.widget = old->widget;
+        }
+        sceneWidth = SceneLayout::originalWidth;
+        sceneHeight = SceneLayout::originalHeight;
+        items.swap(defaults);
+        markAllDirty();
+    }
+
+    // false - такого имени нет в таблице
+    bool bind(const std::string& name, const tgui::Widget::Ptr& widget) {
+        Item* item = find(name);
+        if (!item) return false;
+        item->widget = widget;
+        item->dirty = true;
+        // Кэш относился к прежнему виджету - новому всё ставится заново
+        item->x = item->y = item->width = item->height = -1;
+        item->textSize = 0;
+        return true;
+    }
+
+    // Из onViewChange: только запомнить, применится в update()
+    void resize(float viewWidth, float viewHeight) {
+        pendingWidth = viewWidth;
+        pendingHeight = viewHeight;
+    }
+
+    void markDirty(const std::string& name) {
+        if (Item* item = find(name)) item->dirty = true;
+    }
+
+    void markAllDirty() {
+        for (Item& item : items) item.dirty = true;
+        forceApply = true;
+    }
+
+    // Раз в кадр перед gui.draw(); возвращает число вызовов сеттеров виджетов
+    size_t update() {
+        if (pendingWidth <= 0 || pendingHeight <= 0) return 0;
+
+        if (forceApply || pendingWidth != appliedWidth || pendingHeight != appliedHeight) {
+            const LayoutTransform next = LayoutTransform::fit(pendingWidth, pendingHeight, sceneWidth, sceneHeight);
+            appliedWidth = pendingWidth;
+            appliedHeight = pendingHeight;
+            forceApply = false;
+            if (next.scale != current.scale || next.offsetX != current.offsetX || next.offsetY != current.offsetY) {
+                current = next;
+                for (Item& item : items) item.dirty = true;
+            }
+        }
+
+        size_t calls = 0;
+        for (Item& item : items) {
+            if (!item.dirty || !item.widget) continue;
+            item.dirty = false;
+
+            if (item.placed) {
+                const float w = item.rect.width * current.scale;
+                const float h = item.rect.height * current.scale;
+                const float x = current.offsetX + item.rect.x * current.scale;
+                const float y = current.offsetY + item.rect.y * current.scale;
+                if (w != item.width || h != item.height) {
+                    item.widget->setSize(w, h);
+                    item.width = w;
+                    item.height = h;
+                    ++calls;
+                }
+                if (x != item.x || y != item.y) {
+                    item.widget->setPosition(x, y);
+                    item.x = x;
+                    item.y = y;
+                    ++calls;
+                }
+            }
+
+            if (item.baseTextSize) {
+                const unsigned textSize = std::max(1u, static_cast<unsigned>(item.baseTextSize * current.scale));
+                if (textSize != item.textSize) {
+                    item.widget->setTextSize(textSize);
+                    item.textSize = textSize;
+                    ++calls;
+                }
+            }
+        }
+        return calls;
+    }
+
+    const LayoutTransform& transform() const { return current; }
+    size_t size() const { return items.size(); }
+
+private:
+    struct Item {
+        std::string name;
+        WidgetPosition rect{};
+        bool placed = false;
+        unsigned baseTextSize = 0;
+        tgui::Widget::Ptr widget;
+        bool dirty = true;
+        // Последнее, что ставилось виджету (-1 - ещё ничего)
+        float x = -1, y = -1, width = -1, height = -1;
+        unsigned textSize = 0;
+    };
+
+    Item* find(const std::string& name) {
+        for (Item& item : items) {
+            if (item.name == name) return &item;
+        }
+        return nullptr;
+    }
+
+    std::vector<Item> items;
+    float sceneWidth = SceneLayout::originalWidth;
+    float sceneHeight = SceneLayout::originalHeight;
+    float pendingWidth = 0, pendingHeight = 0;
+    float appliedWidth = 0, appliedHeight = 0;
+    bool forceApply = true;
+    LayoutTransform current{ 0, 0, 0 };
+};
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef MATCH_RULES_H
+#define MATCH_RULES_H
+
+// Правила матча из README
+namespace MatchRules {
+    constexpr int winsPerShot = 2;      // каждые 2 победы - выстрел
+    constexpr int revolverChambers = 6; // 6 патронов в барабане
+    constexpr int liveRounds = 1;       // и только 1 боевой
+    constexpr int diceFaces = 6;        // два кубика d6 на игрока
+}
+
+#endif
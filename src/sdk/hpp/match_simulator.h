@@ -0,0 +1,188 @@
+#ifndef MATCH_SIMULATOR_H
+#define MATCH_SIMULATOR_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "random_system.h"
+#include "dice_kernel.h"
+#include "game_core.h"
+
+struct MatchResult {
+    bool pl1Survived;
+    uint32_t rounds;
+    uint32_t shots;
+};
+
+// Поток исходов раундов: DiceKernel разыгрывает их пачками по DiceBatch::capacity
+class RoundStream {
+public:
+    explicit RoundStream(uint64_t seed) : rng(seed), batch(new DiceBatch) {}
+
+    void reseed(uint64_t seed) {
+        rng.reseed(seed);
+        position = batch->rounds = 0;
+    }
+
+    RoundOutcome next() {
+        if (position == batch->rounds) {
+            DiceKernel::play(rng, *batch, DiceBatch::capacity);
+            position = 0;
+        }
+        return static_cast<RoundOutcome>(batch->outcomes[position++]);
+    }
+
+    FastRandom& random() { return rng; }
+
+private:
+    FastRandom rng;
+    std::unique_ptr<DiceBatch> batch;
+    size_t position = 0;
+};
+
+struct SimulationConfig {
+    uint64_t matches = 1000000;
+    uint64_t seed = 0;
+    unsigned threads = 0;          // 0 - все ядра
+    uint64_t chunkSize = 1 << 14;  // матчей на один поток RNG
+};
+
+struct SimulationStats {
+    static constexpr size_t histogramSize = 128; // последний бакет - "и длиннее"
+
+    uint64_t matches = 0;
+    uint64_t rounds = 0;
+    uint64_t pl1Survived = 0;
+    uint64_t shots = 0;
+    std::array<uint64_t, 3> roundOutcomes{};
+    std::array<uint64_t, histogramSize> matchLength{};
+    double seconds = 0;
+    unsigned threads = 0;
+};
+
+class MatchSimulator {
+public:
+    // Один полный матч на GameCore: раунды 2d6 против 2d6 до первого боевого выстрела
+    static MatchResult playMatch(RoundStream& stream, std::array<uint64_t, 3>* outcomes = nullptr) {
+        GameState state;
+        GameCore::reset(state, stream.random());
+
+        MatchResult result{ false, 0, 0 };
+
+        for (;;) {
+            const RoundOutcome outcome = stream.next();
+            if (outcomes) ++(*outcomes)[static_cast<size_t>(outcome)];
+
+            const GameEvent events = GameCore::apply(state, outcome);
+            if (hasEvent(events, GameEvent::Pl1Fired | GameEvent::Pl2Fired)) ++result.shots;
+            if (hasEvent(events, GameEvent::MatchOver)) break;
+        }
+
+        result.rounds = state.round;
+        result.pl1Survived = state.winner == MatchWinner::Pl1;
+        return result;
+    }
+
+    // Прогон config.matches матчей на всех потоках.
+    // Матчи режутся на чанки фиксированного размера, у каждого чанка свой поток RNG
+    // из (seed, номер чанка) - результат не зависит от числа потоков.
+    static SimulationStats run(const SimulationConfig& config) {
+        unsigned threadCount = config.threads ? config.threads : std::thread::hardware_concurrency();
+        threadCount = std::max(1u, threadCount);
+
+        const uint64_t chunkSize = std::max<uint64_t>(1, config.chunkSize);
+        const uint64_t chunkCount = (config.matches + chunkSize - 1) / chunkSize;
+
+        SharedStats shared;
+        std::atomic<uint64_t> nextChunk{0};
+
+        auto worker = [&] {
+            SimulationStats local;
+            RoundStream stream(0);
+            for (;;) {
+                const uint64_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                if (chunk >= chunkCount) break;
+
+                const uint64_t first = chunk * chunkSize;
+                const uint64_t count = std::min(chunkSize, config.matches - first);
+                stream.reseed(RandomSystem::streamSeed(config.seed, chunk));
+
+                for (uint64_t i = 0; i < count; ++i) {
+                    const MatchResult match = playMatch(stream, &local.roundOutcomes);
+                    local.rounds += match.rounds;
+                    local.shots += match.shots;
+                    local.pl1Survived += match.pl1Survived;
+                    ++local.matchLength[std::min<size_t>(match.rounds, SimulationStats::histogramSize - 1)];
+                }
+                local.matches += count;
+            }
+            shared.add(local);
+        };
+
+        auto begin = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> pool;
+        pool.reserve(threadCount - 1);
+        for (unsigned i = 1; i < threadCount; ++i) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+
+        SimulationStats stats = shared.snapshot();
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        stats.threads = threadCount;
+        return stats;
+    }
+
+private:
+    // Общие счётчики: потоки сливают в них локальные итоги через fetch_add, без мьютекса
+    struct SharedStats {
+        std::atomic<uint64_t> matches{0};
+        std::atomic<uint64_t> rounds{0};
+        std::atomic<uint64_t> pl1Survived{0};
+        std::atomic<uint64_t> shots{0};
+        std::array<std::atomic<uint64_t>, 3> roundOutcomes{};
+        std::array<std::atomic<uint64_t>, SimulationStats::histogramSize> matchLength{};
+
+        void add(const SimulationStats& local) {
+            matches.fetch_add(local.matches, std::memory_order_relaxed);
+            rounds.fetch_add(local.rounds, std::memory_order_relaxed);
+            pl1Survived.fetch_add(local.pl1Survived, std::memory_order_relaxed);
+            shots.fetch_add(local.shots, std::memory_order_relaxed);
+            for (size_t i = 0; i < roundOutcomes.size(); ++i) {
+                roundOutcomes[i].fetch_add(local.roundOutcomes[i], std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < matchLength.size(); ++i) {
+                if (local.matchLength[i]) {
+                    matchLength[i].fetch_add(local.matchLength[i], std::memory_order_relaxed);
+                }
+            }
+        }
+
+        SimulationStats snapshot() const {
+            SimulationStats stats;
+            stats.matches = matches.load();
+            stats.rounds = rounds.load();
+            stats.pl1Survived = pl1Survived.load();
+            stats.shots = shots.load();
+            for (size_t i = 0; i < roundOutcomes.size(); ++i) {
+                stats.roundOutcomes[i] = roundOutcomes[i].load();
+            }
+            for (size_t i = 0; i < matchLength.size(); ++i) {
+                stats.matchLength[i] = matchLength[i].load();
+            }
+            return stats;
+        }
+    };
+};
+
+#endif
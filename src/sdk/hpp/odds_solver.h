@@ -0,0 +1,165 @@
+#ifndef ODDS_SOLVER_H
+#define ODDS_SOLVER_H
+
+#include <array>
+#include <cstddef>
+
+#include "match_rules.h"
+
+// Распределение 2d6, посчитанное при компиляции
+namespace DiceOdds {
+    constexpr int maxSum = 2 * MatchRules::diceFaces;
+
+    constexpr std::array<int, maxSum + 1> makeSumWays() {
+        std::array<int, maxSum + 1> ways{};
+        for (int a = 1; a <= MatchRules::diceFaces; ++a) {
+            for (int b = 1; b <= MatchRules::diceFaces; ++b) {
+                ++ways[a + b];
+            }
+        }
+        return ways;
+    }
+
+    // Число способов выбросить сумму s двумя кубиками
+    constexpr std::array<int, maxSum + 1> sumWays = makeSumWays();
+
+    constexpr int outcomesPerPlayer = MatchRules::diceFaces * MatchRules::diceFaces;
+    constexpr int outcomesPerRound = outcomesPerPlayer * outcomesPerPlayer;
+
+    constexpr int countWins() {
+        int wins = 0;
+        for (int s1 = 0; s1 <= maxSum; ++s1) {
+            for (int s2 = 0; s2 < s1; ++s2) {
+                wins += sumWays[s1] * sumWays[s2];
+            }
+        }
+        return wins;
+    }
+
+    constexpr int countDraws() {
+        int draws = 0;
+        for (int s = 0; s <= maxSum; ++s) {
+            draws += sumWays[s] * sumWays[s];
+        }
+        return draws;
+    }
+
+    constexpr int winWays = countWins();   // 575 из 1296
+    constexpr int drawWays = countDraws(); // 146 из 1296
+    constexpr int loseWays = outcomesPerRound - winWays - drawWays;
+
+    constexpr double pWin = double(winWays) / outcomesPerRound;
+    constexpr double pLose = double(loseWays) / outcomesPerRound;
+    constexpr double pDraw = double(drawWays) / outcomesPerRound;
+
+    static_assert(winWays == loseWays, "2d6 против 2d6 симметричен");
+}
+
+// Состояние матча, от которого зависят шансы: прогресс к выстрелу и сделанные выстрелы
+struct OddsState {
+    int pl1Progress = 0; // победы pl1 с последнего выстрела (0..winsPerShot-1)
+    int pl2Progress = 0;
+    int pl1Shots = 0;    // холостые выстрелы из револьвера pl1 (0..revolverChambers-1)
+    int pl2Shots = 0;
+};
+
+// Точные шансы через цепь Маркова: граф состояний строится один раз при компиляции,
+// запрос - одно чтение из таблицы
+class OddsSolver {
+public:
+    static constexpr int progressStates = MatchRules::winsPerShot;
+    static constexpr int shotStates = MatchRules::revolverChambers;
+    static constexpr size_t stateCount = size_t(progressStates) * progressStates * shotStates * shotStates;
+
+    struct Entry {
+        double pl1Survives;    // P(pl1 выживет) из состояния
+        double expectedRounds; // ожидаемое число оставшихся раундов
+    };
+
+    using Table = std::array<Entry, stateCount>;
+
+    static constexpr size_t index(int pl1Progress, int pl2Progress, int pl1Shots, int pl2Shots) {
+        return ((size_t(pl1Progress) * progressStates + pl2Progress) * shotStates + pl1Shots) * shotStates + pl2Shots;
+    }
+
+    static constexpr bool valid(const OddsState& s) {
+        return s.pl1Progress >= 0 && s.pl1Progress < progressStates &&
+               s.pl2Progress >= 0 && s.pl2Progress < progressStates &&
+               s.pl1Shots >= 0 && s.pl1Shots < shotStates &&
+               s.pl2Shots >= 0 && s.pl2Shots < shotStates;
+    }
+
+    // P(pl1 выживет) из состояния, O(1)
+    static double pl1Survives(const OddsState& s) {
+        return valid(s) ? table()[index(s.pl1Progress, s.pl2Progress, s.pl1Shots, s.pl2Shots)].pl1Survives : 0.0;
+    }
+
+    static double expectedRounds(const OddsState& s) {
+        return valid(s) ? table()[index(s.pl1Progress, s.pl2Progress, s.pl1Shots, s.pl2Shots)].expectedRounds : 0.0;
+    }
+
+    // Из счётчиков очков как в main.cpp (score_pl1_short, score_pl2_short)
+    static OddsState fromScore(short scorePl1, short scorePl2, int pl1Shots, int pl2Shots) {
+        OddsState s;
+        s.pl1Progress = scorePl1 % MatchRules::winsPerShot;
+        s.pl2Progress = scorePl2 % MatchRules::winsPerShot;
+        s.pl1Shots = pl1Shots;
+        s.pl2Shots = pl2Shots;
+        return s;
+    }
+
+    static constexpr Table build() {
+        Table t{};
+        // Переходы ведут либо к большему числу выстрелов, либо к большему прогрессу при тех же
+        // выстрелах - обходим состояния в обратном порядке, ничья учитывается как петля.
+        for (int shots = 2 * (shotStates - 1); shots >= 0; --shots) {
+            for (int progress = 2 * (progressStates - 1); progress >= 0; --progress) {
+                for (int p1 = 0; p1 < progressStates; ++p1) {
+                    const int p2 = progress - p1;
+                    if (p2 < 0 || p2 >= progressStates) continue;
+                    for (int c1 = 0; c1 < shotStates; ++c1) {
+                        const int c2 = shots - c1;
+                        if (c2 < 0 || c2 >= shotStates) continue;
+
+                        const Entry win = afterWin(t, p1, p2, c1, c2, true);
+                        const Entry lose = afterWin(t, p1, p2, c1, c2, false);
+                        const double leave = 1.0 - DiceOdds::pDraw;
+
+                        Entry& e = t[index(p1, p2, c1, c2)];
+                        e.pl1Survives = (DiceOdds::pWin * win.pl1Survives + DiceOdds::pLose * lose.pl1Survives) / leave;
+                        e.expectedRounds = (1.0 + DiceOdds::pWin * win.expectedRounds +
+                                            DiceOdds::pLose * lose.expectedRounds) / leave;
+                    }
+                }
+            }
+        }
+        return t;
+    }
+
+private:
+    // Итог после победы в раунде pl1 (pl1Won) или pl2 - с выстрелом, если набран прогресс
+    static constexpr Entry afterWin(const Table& t, int p1, int p2, int c1, int c2, bool pl1Won) {
+        const int progress = (pl1Won ? p1 : p2) + 1;
+        if (progress < progressStates) {
+            return t[pl1Won ? index(progress, p2, c1, c2) : index(p1, progress, c1, c2)];
+        }
+
+        // Выстрел: боевой патрон равновероятно в любом из оставшихся гнёзд
+        const int fired = pl1Won ? c1 : c2;
+        const double live = double(MatchRules::liveRounds) / (shotStates - fired);
+        if (live >= 1.0) {
+            return Entry{ pl1Won ? 1.0 : 0.0, 0.0 };
+        }
+
+        const Entry& next = t[pl1Won ? index(0, p2, c1 + 1, c2) : index(p1, 0, c1, c2 + 1)];
+        return Entry{ live * (pl1Won ? 1.0 : 0.0) + (1.0 - live) * next.pl1Survives,
+                      (1.0 - live) * next.expectedRounds };
+    }
+
+    static const Table& table() {
+        static constexpr Table t = build();
+        return t;
+    }
+};
+
+#endif
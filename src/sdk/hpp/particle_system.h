@@ -0,0 +1,383 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <SFML/Graphics.hpp>
+#include <TGUI/TGUI.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "random_system.h"
+#include "sprite_batch.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define PARTICLE_SYSTEM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define PARTICLE_SYSTEM_TARGET_SSE2
+#else
+#define PARTICLE_SYSTEM_TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+#endif
+
+// Частицы: кровь, искры выстрела, гильзы. Пул фиксированной ёмкости, состояние - столбцы float (SoA):
+// update() двигает по 4 частицы за раз (SSE2), гасит умершие перестановкой последней на их место
+// и пишет повёрнутые квады прямо в один вершинный буфер. После конструктора ни spawn(), ни update() не аллоцируют.
+// Координаты - вида gui, как у SpriteBatch; рисуется draw() под gui.draw().
+
+// Параметры одного выброса частиц
+struct ParticleBurst {
+    static constexpr uint8_t anyKind = 0xFF;
+
+    float x = 0, y = 0;
+    float direction = 0;           // радианы: 0 - вправо, pi/2 - вниз
+    float spread = 6.2831853f;     // ширина конуса вокруг direction
+    float speedMin = 0, speedMax = 100;
+    float lifeMin = 0.5f, lifeMax = 1.0f;
+    float sizeMin = 2, sizeMax = 4; // половина ширины квада
+    float spinMax = 0;             // радиан/с в обе стороны
+    uint8_t kind = anyKind;        // anyKind - случайный из addKind()
+};
+
+class ParticleSystem {
+public:
+    enum class Path {
+        Scalar,
+        SSE2
+    };
+
+    static constexpr size_t maxKinds = 8;
+
+    // SSE2 есть на любом x86-64, отдельная проверка cpuid не нужна
+    static Path bestPath() {
+#ifdef PARTICLE_SYSTEM_X86
+        return Path::SSE2;
+#else
+        return Path::Scalar;
+#endif
+    }
+
+    static const char* pathName(Path path) {
+        return path == Path::SSE2 ? "sse2" : "scalar";
+    }
+
+    // Вся память выделяется здесь. GPU-буфер - если уже есть контекст OpenGL (после создания окна),
+    // иначе вершины рисуются из памяти
+    explicit ParticleSystem(size_t capacity)
+        : cap(capacity),
+          stride((capacity + 3) & ~size_t(3)),
+          columns(stride * ColumnCount, 0.0f),
+          kinds(stride, 0),
+          vertices(capacity * 6) {
+        gpu = sf::VertexBuffer::isAvailable() && buffer.create(capacity * 6);
+    }
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // Вид частицы - прямоугольник part на странице page (как их отдаёт AssetLoader; пустой part - вся tgui::Texture).
+    // Все виды одной системы - с одной GPU-текстуры, иначе false.
+    // Можно звать из callback'а загрузки: пока видов нет, частицы считаются, но не рисуются
+    bool addKind(const tgui::Texture& page, const tgui::UIntRect& part = {}) {
+        const sf::Texture* native = SpriteBatch::nativeTexture(page);
+        if (!native || kindsLoaded == maxKinds || (texture && native != texture)) return false;
+
+        const tgui::UIntRect rect = part.width && part.height ? part : SpriteBatch::imageRect(page);
+        const float u0 = static_cast<float>(rect.left);
+        const float v0 = static_cast<float>(rect.top);
+        kindRects[kindsLoaded++] = KindRect{ u0, v0, u0 + static_cast<float>(rect.width), v0 + static_cast<float>(rect.height),
+                                             static_cast<float>(rect.height) / static_cast<float>(rect.width) };
+        sheet = page; // держит GPU-текстуру живой
+        texture = native;
+        return true;
+    }
+
+    size_t kindCount() const { return kindsLoaded; }
+
+    // Ускорение в пикселях/с^2 (y вниз) и доля скорости, теряемая за секунду
+    void setGravity(float x, float y) {
+        gravityX = x;
+        gravityY = y;
+    }
+
+    void setDrag(float perSecond) { drag = std::max(0.0f, perSecond); }
+
+    // sf::BlendAdd для искр и вспышек
+    void setBlendMode(const sf::BlendMode& mode) { blend = mode; }
+
+    // Больше свободного места не рождается; возвращает, сколько родилось
+    size_t spawn(const ParticleBurst& burst, size_t count, FastRandom& rng) {
+        count = std::min(count, cap - live);
+        float* px = column(X);
+        float* py = column(Y);
+        float* pvx = column(VX);
+        float* pvy = column(VY);
+        float* pangle = column(Angle);
+        float* pspin = column(Spin);
+        float* palpha = column(Alpha);
+        float* pfade = column(Fade);
+        float* plife = column(Life);
+        float* psize = column(Size);
+
+        const size_t end = live + count;
+        for (size_t i = live; i < end; ++i) {
+            const float direction = burst.direction + burst.spread * (rng.nextFloat() - 0.5f);
+            const float speed = rng.uniformFloat(burst.speedMin, burst.speedMax);
+            const float life = std::max(rng.uniformFloat(burst.lifeMin, burst.lifeMax), minLife);
+            px[i] = burst.x;
+            py[i] = burst.y;
+            pvx[i] = std::cos(direction) * speed;
+            pvy[i] = std::sin(direction) * speed;
+            pangle[i] = rng.uniformFloat(-pi, pi);
+            pspin[i] = rng.uniformFloat(-burst.spinMax, burst.spinMax);
+            palpha[i] = 1.0f;
+            pfade[i] = 1.0f / life;
+            plife[i] = life;
+            psize[i] = rng.uniformFloat(burst.sizeMin, burst.sizeMax);
+            kinds[i] = burst.kind != ParticleBurst::anyKind ? burst.kind
+                       : kindsLoaded ? static_cast<uint8_t>(rng.bounded(static_cast<uint32_t>(kindsLoaded))) : 0;
+        }
+        live = end;
+        return count;
+    }
+
+    void clear() { live = 0; }
+
+    // Раз в кадр: движение, вымирание, вершины и их загрузка в GPU.
+    // true - картинка слоя изменилась (в том числе погасла последняя частица)
+    bool update(float dt, Path path = bestPath()) {
+        if (live == 0 && vertexCount == 0) return false;
+        integrate(dt, path);
+        retire();
+        writeVertices(path);
+        if (gpu && vertexCount) buffer.update(vertices.data(), vertexCount, 0);
+        return true;
+    }
+
+    // Под gui.draw(); view - gui.getView(), как у SpriteBatch
+    void draw(sf::RenderTarget& target, const tgui::FloatRect& view) const {
+        if (!vertexCount || !texture) return;
+        const sf::View previous = target.getView();
+        target.setView(sf::View(sf::FloatRect({ view.left, view.top }, { view.width, view.height })));
+        sf::RenderStates states;
+        states.texture = texture;
+        states.blendMode = blend;
+        if (gpu) target.draw(buffer, 0, vertexCount, states);
+        else target.draw(vertices.data(), vertexCount, sf::PrimitiveType::Triangles, states);
+        target.setView(previous);
+    }
+
+    size_t size() const { return live; }
+    size_t capacity() const { return cap; }
+    bool busy() const { return live != 0; }
+    bool onGpu() const { return gpu; }
+
+private:
+    enum Column { X, Y, VX, VY, Angle, Spin, Alpha, Fade, Life, Size, ColumnCount };
+
+    struct KindRect {
+        float u0, v0, u1, v1;
+        float aspect; // высота / ширина: квад повторяет пропорции спрайта
+    };
+
+    static constexpr float pi = 3.14159265f;
+    static constexpr float twoPi = 6.28318531f;
+    static constexpr float minLife = 1.0f / 1000;
+
+    float* column(Column c) { return columns.data() + c * stride; }
+    const float* column(Column c) const { return columns.data() + c * stride; }
+
+    void integrate(float dt, Path path) {
+        const float damping = std::max(0.0f, 1.0f - drag * dt);
+        size_t i = 0;
+#ifdef PARTICLE_SYSTEM_X86
+        if (path == Path::SSE2) i = integrateSse2(dt, damping);
+#else
+        (void)path;
+#endif
+        float* px = column(X);
+        float* py = column(Y);
+        float* pvx = column(VX);
+        float* pvy = column(VY);
+        float* pangle = column(Angle);
+        const float* pspin = column(Spin);
+        float* palpha = column(Alpha);
+        const float* pfade = column(Fade);
+        float* plife = column(Life);
+        for (; i < live; ++i) {
+            pvx[i] = (pvx[i] + gravityX * dt) * damping;
+            pvy[i] = (pvy[i] + gravityY * dt) * damping;
+            px[i] += pvx[i] * dt;
+            py[i] += pvy[i] * dt;
+            // угол держится в [-pi, pi] - на этом отрезке работает быстрый синус
+            const float angle = pangle[i] + pspin[i] * dt;
+            pangle[i] = angle - twoPi * std::nearbyint(angle * (1.0f / twoPi));
+            palpha[i] = std::max(palpha[i] - pfade[i] * dt, 0.0f);
+            plife[i] -= dt;
+        }
+    }
+
+    // Умершая частица заменяется последней живой - порядок не сохраняется, дыр нет
+    void retire() {
+        float* plife = column(Life);
+        for (size_t i = 0; i < live;) {
+            if (plife[i] > 0) {
+                ++i;
+                continue;
+            }
+            --live;
+            for (size_t c = 0; c < ColumnCount; ++c) {
+                float* values = columns.data() + c * stride;
+                values[i] = values[live];
+            }
+            kinds[i] = kinds[live];
+        }
+    }
+
+    void writeVertices(Path path) {
+        size_t i = 0;
+#ifdef PARTICLE_SYSTEM_X86
+        if (path == Path::SSE2) i = writeSse2();
+#else
+        (void)path;
+#endif
+        const float* pangle = column(Angle);
+        for (; i < live; ++i) {
+            writeQuad(i, fastSin(cosArgument(pangle[i])), fastSin(pangle[i]));
+        }
+        vertexCount = live * 6;
+    }
+
+    // Синус на [-pi, pi] двумя параболами, ошибка ~0.001 - для поворота спрайта хватает
+    static float fastSin(float x) {
+        const float y = x * (4 / pi) - x * std::fabs(x) * (4 / (pi * pi));
+        return y + 0.225f * (y * std::fabs(y) - y);
+    }
+
+    // cos x = sin(x + pi/2), аргумент возвращается в [-pi, pi]
+    static float cosArgument(float x) {
+        const float shifted = x + pi / 2;
+        return shifted > pi ? shifted - twoPi : shifted;
+    }
+
+    // Углы квада (+-w, +-h) повёрнуты на угол частицы: w = size, h = size * aspect
+    void writeQuad(size_t i, float cosine, float sine) {
+        const KindRect& k = kindRects[kinds[i] < kindsLoaded ? kinds[i] : 0];
+        const float x = column(X)[i];
+        const float y = column(Y)[i];
+        const float w = column(Size)[i];
+        const float h = w * k.aspect;
+        const float wc = w * cosine, ws = w * sine, hc = h * cosine, hs = h * sine;
+        const sf::Color color(255, 255, 255, static_cast<uint8_t>(column(Alpha)[i] * 255.0f));
+
+        const sf::Vertex topLeft{ { x - wc + hs, y - ws - hc }, color, { k.u0, k.v0 } };
+        const sf::Vertex topRight{ { x + wc + hs, y + ws - hc }, color, { k.u1, k.v0 } };
+        const sf::Vertex bottomRight{ { x + wc - hs, y + ws + hc }, color, { k.u1, k.v1 } };
+        const sf::Vertex bottomLeft{ { x - wc - hs, y - ws + hc }, color, { k.u0, k.v1 } };
+
+        sf::Vertex* quad = vertices.data() + i * 6;
+        quad[0] = topLeft;
+        quad[1] = topRight;
+        quad[2] = bottomLeft;
+        quad[3] = bottomLeft;
+        quad[4] = topRight;
+        quad[5] = bottomRight;
+    }
+
+#ifdef PARTICLE_SYSTEM_X86
+    PARTICLE_SYSTEM_TARGET_SSE2
+    size_t integrateSse2(float dt, float damping) {
+        float* px = column(X);
+        float* py = column(Y);
+        float* pvx = column(VX);
+        float* pvy = column(VY);
+        float* pangle = column(Angle);
+        const float* pspin = column(Spin);
+        float* palpha = column(Alpha);
+        const float* pfade = column(Fade);
+        float* plife = column(Life);
+
+        const __m128 t = _mm_set1_ps(dt);
+        const __m128 damp = _mm_set1_ps(damping);
+        const __m128 gx = _mm_set1_ps(gravityX * dt);
+        const __m128 gy = _mm_set1_ps(gravityY * dt);
+        const __m128 turn = _mm_set1_ps(twoPi);
+        const __m128 perTurn = _mm_set1_ps(1.0f / twoPi);
+        const __m128 zero = _mm_setzero_ps();
+
+        size_t i = 0;
+        for (; i + 4 <= live; i += 4) {
+            const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pvx + i), gx), damp);
+            const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pvy + i), gy), damp);
+            _mm_storeu_ps(pvx + i, vx);
+            _mm_storeu_ps(pvy + i, vy);
+            _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(vx, t)));
+            _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(vy, t)));
+
+            // округление cvtps - к ближнему чётному, как std::nearbyint в скалярном хвосте
+            const __m128 angle = _mm_add_ps(_mm_loadu_ps(pangle + i), _mm_mul_ps(_mm_loadu_ps(pspin + i), t));
+            const __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(angle, perTurn)));
+            _mm_storeu_ps(pangle + i, _mm_sub_ps(angle, _mm_mul_ps(turn, turns)));
+
+            const __m128 alpha = _mm_sub_ps(_mm_loadu_ps(palpha + i), _mm_mul_ps(_mm_loadu_ps(pfade + i), t));
+            _mm_storeu_ps(palpha + i, _mm_max_ps(alpha, zero));
+            _mm_storeu_ps(plife + i, _mm_sub_ps(_mm_loadu_ps(plife + i), t));
+        }
+        return i;
+    }
+
+    PARTICLE_SYSTEM_TARGET_SSE2
+    static __m128 fastSin4(__m128 x) {
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        const __m128 ax = _mm_andnot_ps(sign, x);
+        const __m128 y = _mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(4 / pi)),
+                                    _mm_mul_ps(_mm_mul_ps(x, ax), _mm_set1_ps(4 / (pi * pi))));
+        const __m128 ay = _mm_andnot_ps(sign, y);
+        return _mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(0.225f), _mm_sub_ps(_mm_mul_ps(y, ay), y)));
+    }
+
+    PARTICLE_SYSTEM_TARGET_SSE2
+    size_t writeSse2() {
+        const float* pangle = column(Angle);
+        const __m128 quarter = _mm_set1_ps(pi / 2);
+        const __m128 half = _mm_set1_ps(pi);
+        const __m128 turn = _mm_set1_ps(twoPi);
+        alignas(16) float cosine[4];
+        alignas(16) float sine[4];
+
+        size_t i = 0;
+        for (; i + 4 <= live; i += 4) {
+            const __m128 angle = _mm_loadu_ps(pangle + i);
+            const __m128 shifted = _mm_add_ps(angle, quarter);
+            const __m128 wrapped = _mm_sub_ps(shifted, _mm_and_ps(_mm_cmpgt_ps(shifted, half), turn));
+            _mm_store_ps(cosine, fastSin4(wrapped));
+            _mm_store_ps(sine, fastSin4(angle));
+            for (size_t lane = 0; lane < 4; ++lane) writeQuad(i + lane, cosine[lane], sine[lane]);
+        }
+        return i;
+    }
+#endif
+
+    size_t cap;
+    size_t stride; // длина столбца, кратна 4
+    size_t live = 0;
+    std::vector<float> columns;   // ColumnCount столбцов по stride
+    std::vector<uint8_t> kinds;
+    std::vector<sf::Vertex> vertices; // 6 на частицу, индекс квада = индекс частицы
+    size_t vertexCount = 0;
+    sf::VertexBuffer buffer{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Stream };
+    bool gpu = false;
+
+    KindRect kindRects[maxKinds] = {};
+    size_t kindsLoaded = 0;
+    tgui::Texture sheet;
+    const sf::Texture* texture = nullptr;
+    sf::BlendMode blend = sf::BlendAlpha;
+
+    float gravityX = 0, gravityY = 0;
+    float drag = 0;
+};
+
+#endif
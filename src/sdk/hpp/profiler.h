@@ -0,0 +1,196 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Профайлер фаз кадра: PROFILE_SCOPE("draw") пишет интервал в lock-free кольцо.
+// Выключенный в рантайме стоит одну relaxed-загрузку и ветку; с PROFILER_DISABLED макросы пустые.
+
+struct ProfileEvent {
+    const char* name;    // строковый литерал - указатель живёт всю программу
+    uint64_t beginNs;    // от старта профайлера
+    uint32_t durationNs;
+    uint32_t thread;
+};
+
+class Profiler {
+public:
+    static constexpr size_t eventCapacity = 1 << 16; // последние ~65k интервалов
+    static constexpr size_t frameCapacity = 256;     // история длительности кадров для графика
+
+    static void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch()).count());
+    }
+
+    // Интервал из любого потока: место в кольце занимается fetch_add, старые записи затираются
+    static void record(const char* name, uint64_t beginNs, uint64_t endNs) {
+        const uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = events[index & (eventCapacity - 1)];
+        slot.sequence.store(0, std::memory_order_relaxed); // пишется - читатель пропустит
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.beginNs.store(beginNs, std::memory_order_relaxed);
+        slot.durationNs.store(static_cast<uint32_t>(std::min<uint64_t>(endNs - beginNs, UINT32_MAX)), std::memory_order_relaxed);
+        slot.thread.store(threadIndex(), std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    // Границы кадра из главного цикла
+    static void frameBegin() {
+        if (!isEnabled()) return;
+        frameStart = nowNs();
+    }
+
+    static void frameEnd() {
+        if (!isEnabled() || !frameStart) return;
+        const uint64_t end = nowNs();
+        record("frame", frameStart, end);
+        frameTimes[frameCount % frameCapacity] = static_cast<float>((end - frameStart) * 1e-6);
+        ++frameCount;
+        frameStart = 0;
+    }
+
+    // Длительности последних кадров в мс, от старых к новым
+    static size_t frameHistory(float* out, size_t capacity) {
+        const size_t count = std::min<size_t>({ frameCount, frameCapacity, capacity });
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = frameTimes[(frameCount - count + i) % frameCapacity];
+        }
+        return count;
+    }
+
+    // Перцентиль (0..1) длительности кадра в мс по истории
+    static float framePercentile(double q) {
+        float sorted[frameCapacity];
+        const size_t count = frameHistory(sorted, frameCapacity);
+        if (count == 0) return 0;
+        std::sort(sorted, sorted + count);
+        return sorted[std::min(count - 1, static_cast<size_t>(q * count))];
+    }
+
+    // Снимок целых записей кольца (не больше limit последних), от старых к новым
+    static size_t snapshot(std::vector<ProfileEvent>& out, size_t limit = eventCapacity) {
+        out.clear();
+        const uint64_t end = head.load(std::memory_order_acquire);
+        const uint64_t window = std::min(limit, eventCapacity);
+        const uint64_t begin = end > window ? end - window : 0;
+        for (uint64_t index = begin; index < end; ++index) {
+            const Slot& slot = events[index & (eventCapacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1) continue;
+            const ProfileEvent event{ slot.name.load(std::memory_order_relaxed), slot.beginNs.load(std::memory_order_relaxed),
+                                      slot.durationNs.load(std::memory_order_relaxed), slot.thread.load(std::memory_order_relaxed) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != index + 1) continue; // затёрто во время чтения
+            out.push_back(event);
+        }
+        return out.size();
+    }
+
+    // Средняя длительность фазы name по последним lastFrames записям снимка, мс
+    static float averageMs(const std::vector<ProfileEvent>& events, const char* name, size_t lastFrames = 60) {
+        uint64_t total = 0;
+        size_t seen = 0;
+        for (size_t i = events.size(); i-- > 0 && seen < lastFrames;) {
+            if (std::strcmp(events[i].name, name) == 0) { // литералы из разных единиц трансляции не обязаны совпадать
+                total += events[i].durationNs;
+                ++seen;
+            }
+        }
+        return seen ? static_cast<float>(total * 1e-6 / seen) : 0.0f;
+    }
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto)
+    static bool writeChromeTrace(const char* path) {
+        std::vector<ProfileEvent> list;
+        snapshot(list);
+
+        FILE* file = std::fopen(path, "w");
+        if (!file) return false;
+        std::fprintf(file, "{\"traceEvents\":[\n");
+        for (size_t i = 0; i < list.size(); ++i) {
+            const ProfileEvent& e = list[i];
+            std::fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}%s\n",
+                         e.name, e.beginNs * 1e-3, e.durationNs * 1e-3, e.thread, i + 1 < list.size() ? "," : "");
+        }
+        std::fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+        std::fclose(file);
+        return true;
+    }
+
+private:
+    // Поля атомарные (relaxed): запись и чтение снимка идут без блокировок, seqlock отсеивает рваные записи
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> beginNs{0};
+        std::atomic<uint32_t> durationNs{0};
+        std::atomic<uint32_t> thread{0};
+    };
+
+    static std::chrono::steady_clock::time_point epoch() {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+
+    static uint32_t threadIndex() {
+        static std::atomic<uint32_t> next{1};
+        thread_local const uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    static std::atomic<bool> enabled;
+    static std::atomic<uint64_t> head;
+    static Slot events[eventCapacity];
+    static uint64_t frameStart;
+    static uint64_t frameCount;
+    static float frameTimes[frameCapacity];
+};
+
+// Замер области видимости; при выключенном профайлере время не читается
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* scopeName) : name(scopeName), begin(Profiler::isEnabled() ? Profiler::nowNs() : 0) {}
+
+    ~ProfileScope() {
+        if (begin) Profiler::record(name, begin, Profiler::nowNs());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t begin;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef PROFILER_DISABLED
+#define PROFILE_SCOPE(name)
+#define PROFILE_FRAME_BEGIN()
+#define PROFILE_FRAME_END()
+#else
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FRAME_BEGIN() Profiler::frameBegin()
+#define PROFILE_FRAME_END() Profiler::frameEnd()
+#endif
+
+std::atomic<bool> Profiler::enabled{false};
+std::atomic<uint64_t> Profiler::head{0};
+Profiler::Slot Profiler::events[Profiler::eventCapacity];
+uint64_t Profiler::frameStart = 0;
+uint64_t Profiler::frameCount = 0;
+float Profiler::frameTimes[Profiler::frameCapacity] = {};
+
+#endif
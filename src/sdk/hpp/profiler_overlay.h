@@ -0,0 +1,133 @@
+#ifndef PROFILER_OVERLAY_H
+#define PROFILER_OVERLAY_H
+
+#include <TGUI/TGUI.hpp>
+#include <TGUI/Backend/SFML-Graphics.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "alloc_tracker.h"
+#include "profiler.h"
+
+// Оверлей профайлера поверх сцены: график длительности кадров, p50/p99, средние по фазам
+// и аллокации последней области каждого тега ALLOC_SCOPE (если перехват new/delete собран).
+// Показ (F3) включает и сбор данных; скрытый оверлей ничего не рисует и не считает.
+class ProfilerOverlay {
+public:
+    static constexpr float graphWidth = 256.0f;  // по пикселю на кадр истории
+    static constexpr float graphHeight = 80.0f;
+    static constexpr float graphMaxMs = 50.0f;   // выше - столбик обрезается
+    static constexpr float budgetMs = 1000.0f / 60.0f;
+
+    ProfilerOverlay(tgui::Gui& gui, std::vector<const char*> phaseNames)
+        : phases(std::move(phaseNames)) {
+        canvas = tgui::CanvasSFML::create({ graphWidth, graphHeight });
+        canvas->setPosition(8, 8);
+        canvas->setVisible(false);
+
+        label = tgui::Label::create();
+        label->setPosition(8, 8 + graphHeight + 4);
+        label->setTextSize(13);
+        label->getRenderer()->setTextColor(tgui::Color::White);
+        label->setVisible(false);
+
+        // Добавляются последними - рисуются поверх стола
+        gui.add(canvas);
+        gui.add(label);
+    }
+
+    void toggle() { setVisible(!visible); }
+
+    void setVisible(bool on) {
+        visible = on;
+        Profiler::setEnabled(on);
+        canvas->setVisible(on);
+        label->setVisible(on);
+    }
+
+    bool isVisible() const { return visible; }
+
+    // Раз в кадр перед gui.draw(); текст обновляется реже, чтобы цифры читались
+    void update() {
+        if (!visible) return;
+        drawGraph();
+        if (++framesSinceText >= textInterval) {
+            framesSinceText = 0;
+            updateText();
+        }
+    }
+
+private:
+    static constexpr unsigned textInterval = 15;
+    static constexpr size_t snapshotEvents = 4096; // хватает на ~60 кадров по всем фазам
+
+    void drawGraph() {
+        float history[Profiler::frameCapacity];
+        const size_t count = Profiler::frameHistory(history, Profiler::frameCapacity);
+
+        bars.clear();
+        bars.setPrimitiveType(sf::PrimitiveType::Triangles);
+        const float left = graphWidth - static_cast<float>(count);
+        for (size_t i = 0; i < count; ++i) {
+            const float ms = std::min(history[i], graphMaxMs);
+            const float x0 = left + static_cast<float>(i);
+            const float x1 = x0 + 1.0f;
+            const float y0 = graphHeight - ms / graphMaxMs * graphHeight;
+            const sf::Color color = history[i] > budgetMs ? sf::Color(230, 70, 50) : sf::Color(90, 200, 90);
+            bars.append({ { x0, y0 }, color });
+            bars.append({ { x1, y0 }, color });
+            bars.append({ { x1, graphHeight }, color });
+            bars.append({ { x0, y0 }, color });
+            bars.append({ { x1, graphHeight }, color });
+            bars.append({ { x0, graphHeight }, color });
+        }
+
+        // Линия бюджета 60 FPS
+        const float budgetY = graphHeight - budgetMs / graphMaxMs * graphHeight;
+        const sf::Vertex budget[2] = { { { 0, budgetY }, sf::Color(255, 255, 255, 160) },
+                                       { { graphWidth, budgetY }, sf::Color(255, 255, 255, 160) } };
+
+        canvas->clear(sf::Color(0, 0, 0, 160));
+        canvas->draw(bars);
+        canvas->draw(budget, 2, sf::PrimitiveType::Lines);
+        canvas->display();
+    }
+
+    void updateText() {
+        Profiler::snapshot(events, snapshotEvents);
+
+        char line[64];
+        std::snprintf(line, sizeof(line), "frame p50 %.2f ms  p99 %.2f ms",
+                      Profiler::framePercentile(0.5), Profiler::framePercentile(0.99));
+        std::string text = line;
+        for (const char* phase : phases) {
+            std::snprintf(line, sizeof(line), "\n%-10s %.3f ms", phase, Profiler::averageMs(events, phase));
+            text += line;
+        }
+
+        if (AllocTracker::hooked()) {
+            AllocTracker::tags(allocTags);
+            for (const AllocTagStats& stats : allocTags) {
+                std::snprintf(line, sizeof(line), "\n%-10s %llu allocs %llu B peak %lld B", stats.tag,
+                              (unsigned long long)stats.lastAllocations, (unsigned long long)stats.lastBytes,
+                              (long long)stats.lastPeak);
+                text += line;
+            }
+        }
+        label->setText(text);
+    }
+
+    std::vector<const char*> phases;
+    tgui::CanvasSFML::Ptr canvas;
+    tgui::Label::Ptr label;
+    sf::VertexArray bars;
+    std::vector<ProfileEvent> events;
+    std::vector<AllocTagStats> allocTags;
+    bool visible = false;
+    unsigned framesSinceText = 0;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef RANDOM_SYSTEM_H
+#define RANDOM_SYSTEM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <random>
+#include <limits>
+#include <type_traits>
+
+// SplitMix64 - разворачивает один seed в состояние генератора
+struct SplitMix64 {
+    uint64_t state;
+
+    explicit SplitMix64(uint64_t seed = 0) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// xoshiro256** - быстрый генератор с состоянием 32 байта (вместо ~5 КБ у mt19937)
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    explicit Xoshiro256(uint64_t value = 0x5EED5EED5EED5EEDull) { seed(value); }
+
+    void seed(uint64_t value) {
+        SplitMix64 sm(value);
+        for (auto& word : s) {
+            word = sm.next();
+        }
+    }
+
+    result_type operator()() {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+
+        return result;
+    }
+
+    // Прыжок на 2^128 шагов - независимые потоки из одного seed
+    void jump() {
+        static const uint64_t JUMP[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                         0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+        uint64_t t[4] = { 0, 0, 0, 0 };
+        for (uint64_t word : JUMP) {
+            for (int b = 0; b < 64; ++b) {
+                if (word & (uint64_t(1) << b)) {
+                    t[0] ^= s[0];
+                    t[1] ^= s[1];
+                    t[2] ^= s[2];
+                    t[3] ^= s[3];
+                }
+                (*this)();
+            }
+        }
+        s[0] = t[0];
+        s[1] = t[1];
+        s[2] = t[2];
+        s[3] = t[3];
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t s[4];
+};
+
+// Обёртка над генератором: ограниченные целые без смещения, float и пакетные броски
+template <class Engine>
+class RandomStream {
+public:
+    using engine_type = Engine;
+
+    explicit RandomStream(uint64_t value = 0) { reseed(value); }
+
+    void reseed(uint64_t value) {
+        SplitMix64 sm(value);
+        if constexpr (std::is_same<Engine, Xoshiro256>::value) {
+            gen.seed(value);
+        } else {
+            uint32_t words[8];
+            for (auto& w : words) {
+                w = static_cast<uint32_t>(sm.next() >> 32);
+            }
+            std::seed_seq seq(std::begin(words), std::end(words));
+            gen.seed(seq);
+        }
+    }
+
+    Engine& engine() { return gen; }
+
+    uint32_t nextU32() {
+        if constexpr (Engine::max() - Engine::min() >= 0xFFFFFFFFFFFFFFFFull) {
+            return static_cast<uint32_t>(gen() >> 32);
+        } else {
+            return static_cast<uint32_t>(gen());
+        }
+    }
+
+    uint64_t nextU64() {
+        if constexpr (Engine::max() - Engine::min() >= 0xFFFFFFFFFFFFFFFFull) {
+            return gen();
+        } else {
+            const uint64_t hi = static_cast<uint32_t>(gen());
+            return (hi << 32) | static_cast<uint32_t>(gen());
+        }
+    }
+
+    // [0, range) без смещения - метод Лемира (одно умножение, деление только при отбраковке)
+    uint32_t bounded(uint32_t range) {
+        return boundedFrom(nextU32(), range);
+    }
+
+    // [one, two] включительно, как uniform_int_distribution
+    int uniformInt(int one, int two) {
+        const uint32_t range = static_cast<uint32_t>(two) - static_cast<uint32_t>(one) + 1u;
+        if (range == 0) {
+            return static_cast<int>(nextU32());
+        }
+        return static_cast<int>(static_cast<uint32_t>(one) + bounded(range));
+    }
+
+    // [0, 1) с 24 битами точности
+    float nextFloat() {
+        return (nextU32() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // [one, two), как uniform_real_distribution
+    float uniformFloat(float one, float two) {
+        return one + (two - one) * nextFloat();
+    }
+
+    // Заполняет буфер count гранями кубика 1..faces: два броска на одно 64-битное слово
+    void rollDice(short* out, size_t count, short faces = 6) {
+        const uint32_t range = static_cast<uint32_t>(faces);
+        size_t i = 0;
+        for (; i + 1 < count; i += 2) {
+            const uint64_t word = nextU64();
+            out[i] = static_cast<short>(1 + boundedFrom(static_cast<uint32_t>(word >> 32), range));
+            out[i + 1] = static_cast<short>(1 + boundedFrom(static_cast<uint32_t>(word), range));
+        }
+        if (i < count) {
+            out[i] = static_cast<short>(1 + bounded(range));
+        }
+    }
+
+private:
+    uint32_t boundedFrom(uint32_t x, uint32_t range) {
+        uint64_t m = uint64_t(x) * range;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < range) {
+            const uint32_t threshold = (0u - range) % range;
+            while (low < threshold) {
+                m = uint64_t(nextU32()) * range;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    Engine gen;
+};
+
+using FastRandom = RandomStream<Xoshiro256>;
+using MtRandom = RandomStream<std::mt19937>;
+
+// Генератор на каждый поток: random_device читается один раз при первом обращении потока
+class RandomSystem {
+public:
+    static FastRandom& local() {
+        thread_local FastRandom rng(entropySeed());
+        return rng;
+    }
+
+    // Детерминированный seed для текущего потока
+    static void seed(uint64_t value) {
+        local().reseed(value);
+    }
+
+    // Независимый seed для потока/чанка stream из базового seed
+    static uint64_t streamSeed(uint64_t base, uint64_t stream) {
+        SplitMix64 sm(base ^ (stream * 0xD1B54A32D192ED03ull));
+        sm.next();
+        return sm.next();
+    }
+
+private:
+    static uint64_t entropySeed() {
+        std::random_device rd;
+        return (uint64_t(rd()) << 32) | rd();
+    }
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef RENDER_SCHEDULER_H
+#define RENDER_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+// Перерисовка по требованию: кадр рисуется, только если его что-то испортило.
+// invalidate() зовут обработчики событий, таймеры, загрузчик, анимации, раскладка (можно из любого потока);
+// в простое главный цикл спит в waitEvent до события или ближайшего таймера вместо 60 одинаковых кадров в секунду.
+class RenderScheduler {
+public:
+    static constexpr double frameSeconds = 1.0 / 60; // сон, пока что-то идёт само (анимация, загрузка)
+    static constexpr double maxIdleSeconds = 0.25;   // дольше не спим - invalidate() из других потоков подхватится
+    static constexpr double minSleepSeconds = 0.001; // waitEvent с нулём ждёт бесконечно
+
+    static void invalidate() { dirty.store(true, std::memory_order_release); }
+    static bool isDirty() { return dirty.load(std::memory_order_acquire); }
+
+    // Сколько ждать событие перед кадром: 0 - кадр уже нужен, не ждать;
+    // busy - что-то меняется каждый кадр; untilTimer - секунды до ближайшего таймера
+    static double sleepSeconds(bool busy, double untilTimer) {
+        if (isDirty()) return 0;
+        if (busy) return frameSeconds;
+        return std::clamp(untilTimer, minSleepSeconds, maxIdleSeconds);
+    }
+
+    // Перед отрисовкой: true - рисовать (флаг сбрасывается), false - кадр пропускается
+    static bool beginFrame() {
+        if (!dirty.exchange(false, std::memory_order_acq_rel)) {
+            ++skipped;
+            return false;
+        }
+        ++drawn;
+        return true;
+    }
+
+    static uint64_t drawnFrames() { return drawn; }
+    static uint64_t skippedFrames() { return skipped; }
+
+private:
+    static std::atomic<bool> dirty;
+    static uint64_t drawn;
+    static uint64_t skipped;
+};
+
+std::atomic<bool> RenderScheduler::dirty{true}; // первый кадр рисуется всегда
+uint64_t RenderScheduler::drawn = 0;
+uint64_t RenderScheduler::skipped = 0;
+
+#endif
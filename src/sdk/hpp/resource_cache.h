@@ -0,0 +1,362 @@
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+
+#include <TGUI/TGUI.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "inline_function.h"
+#include "texture_atlas.h"
+
+// Общий кэш ресурсов по ID ("textures/game/cup/glass_up.png", "fonts/Hero-Bold.ttf", "themes/theme.txt").
+// Текстура, шрифт или тема грузится при первом обращении и дальше раздаётся копиями
+// (копии tgui::Texture/Font делят одни данные). Спрайт атласа - прямоугольник на общей странице: страница -
+// отдельная запись, её память считается один раз, спрайты держат её закреплённой. Незакреплённые ресурсы,
+// к которым давно не обращались, выгружаются, когда оценка занятой памяти превышает бюджет. Только главный поток.
+
+enum class ResourceClass : uint8_t {
+    Texture,
+    Font,
+    Theme,
+    Count
+};
+
+struct ResourceClassStats {
+    size_t count = 0;
+    size_t bytes = 0;       // оценка: текстура - w*h*4 (страница атласа - один раз, её спрайты - 0), шрифт и тема - размер файла
+    size_t loads = 0;
+    size_t evictions = 0;
+};
+
+class ResourceCache;
+
+// Закрепление ресурса: пока жива хотя бы одна ссылка, кэш его не выгружает
+class ResourceRef {
+public:
+    ResourceRef() = default;
+    ResourceRef(const ResourceRef& other) : ResourceRef(other.cache, other.id) {}
+    ResourceRef(ResourceRef&& other) noexcept : cache(other.cache), id(std::move(other.id)) { other.cache = nullptr; }
+    ResourceRef& operator=(ResourceRef other) noexcept {
+        std::swap(cache, other.cache);
+        std::swap(id, other.id);
+        return *this;
+    }
+    ~ResourceRef();
+
+    explicit operator bool() const { return cache != nullptr; }
+    const std::string& resource() const { return id; }
+
+private:
+    friend class ResourceCache;
+    ResourceRef(ResourceCache* owner, std::string resourceId);
+
+    ResourceCache* cache = nullptr;
+    std::string id;
+};
+
+class ResourceCache {
+public:
+    explicit ResourceCache(size_t budgetBytes = 256u << 20) : budget(budgetBytes) {}
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    // Источники: пак, атлас (спрайты под atlasPrefix), фоновый загрузчик, каталог свободных файлов
+    void setPack(const AssetPack* assetPack) { pack = assetPack; }
+    void setAtlas(const TextureAtlas* textureAtlas, const std::string& prefix = "textures/game/") {
+        atlas = textureAtlas;
+        atlasPrefix = prefix;
+    }
+    void setLoader(AssetLoader* assetLoader) { loader = assetLoader; }
+    void setRoot(const std::string& directory) { root = directory; }
+
+    void setBudget(size_t bytes) {
+        budget = bytes;
+        trim();
+    }
+
+    // Синхронно: из кэша или загрузка сейчас. Возвращает страницу; part - прямоугольник ресурса на ней
+    tgui::Texture texture(const std::string& id, tgui::UIntRect* part = nullptr) {
+        Entry& entry = lookup(id, ResourceClass::Texture);
+        if (entry.state != State::Ready) loadTexture(entry);
+        if (part) *part = entry.part;
+        return entry.texture;
+    }
+
+    // Асинхронно через AssetLoader: onReady вызывается из pump() (или сразу, если уже в кэше).
+    // Не загрузилось - onReady с пустыми страницей и part, запись снова пуста (следующий запрос попробует заново)
+    void textureAsync(const std::string& id, AssetPriority priority, AssetReady onReady) {
+        Entry& entry = lookup(id, ResourceClass::Texture);
+        if (entry.state == State::Ready || !loader) {
+            if (entry.state != State::Ready) loadTexture(entry);
+            if (onReady) onReady(entry.texture, entry.part);
+            return;
+        }
+        const std::string sprite = atlasName(entry.id);
+        if (!sprite.empty() && entry.state == State::Empty) {
+            // Страница уже в кэше - спрайт готов без обращения к загрузчику
+            Entry& page = lookup(atlas->pageFile(atlas->region(sprite)->page), ResourceClass::Texture);
+            if (page.state == State::Ready) {
+                const AtlasRegion& r = *atlas->region(sprite);
+                finishSprite(entry, page, tgui::UIntRect(r.x, r.y, r.width, r.height));
+                if (onReady) onReady(entry.texture, entry.part);
+                return;
+            }
+        }
+        if (onReady) entry.waiting.push_back(std::move(onReady));
+        if (entry.state == State::Loading) return;
+
+        entry.state = State::Loading;
+        Entry* target = &entry;
+        AssetReady loaded = [this, target](const tgui::Texture& page, const tgui::UIntRect& part) {
+            finishAsync(*target, page, part);
+        };
+        if (!sprite.empty()) {
+            const AtlasRegion& r = *atlas->region(sprite);
+            loader->request(pagePath(r.page), priority, std::move(loaded), tgui::UIntRect(r.x, r.y, r.width, r.height));
+        } else {
+            loader->request(root + entry.id, priority, std::move(loaded));
+        }
+    }
+
+    tgui::Font font(const std::string& id) {
+        Entry& entry = lookup(id, ResourceClass::Font);
+        if (entry.state != State::Ready) {
+            if (!pack || !pack->font(entry.id, entry.font)) entry.font = tgui::Font(root + entry.id);
+            const AssetView bytes = pack ? pack->view(entry.id) : AssetView{};
+            finishLoad(entry, bytes ? bytes.size : fileSize(root + entry.id));
+        }
+        return entry.font;
+    }
+
+    // Тема разбирается один раз на файл, рендереры секций общие для всех виджетов
+    std::shared_ptr<tgui::RendererData> renderer(const std::string& themeId, const std::string& section) {
+        Entry& entry = lookup(themeId, ResourceClass::Theme);
+        if (entry.state != State::Ready) {
+            entry.theme = tgui::Theme::create(root + entry.id);
+            finishLoad(entry, fileSize(root + entry.id));
+        }
+        return entry.theme->getRenderer(section);
+    }
+
+    // Закрепить ресурс (загрузка не запускается - только защита от выгрузки)
+    ResourceRef acquire(const std::string& id, ResourceClass type) {
+        lookup(id, type);
+        return ResourceRef(this, AssetPack::normalize(id));
+    }
+
+    bool contains(const std::string& id) const {
+        auto it = entries.find(AssetPack::normalize(id));
+        return it != entries.end() && it->second.state == State::Ready;
+    }
+
+    // Выгрузить незакреплённые ресурсы, начиная с самых давних, пока не уложимся в бюджет
+    void trim() {
+        while (resident > budget) {
+            Entry* coldest = nullptr;
+            for (auto& item : entries) {
+                Entry& e = item.second;
+                if (e.state != State::Ready || e.pins > 0) continue;
+                if (!coldest || e.lastUse < coldest->lastUse) coldest = &e;
+            }
+            if (!coldest) return; // всё закреплено - бюджет превышен, но выгружать нечего
+            evict(*coldest);
+        }
+    }
+
+    const ResourceClassStats& stats(ResourceClass type) const { return classStats[static_cast<size_t>(type)]; }
+    size_t residentBytes() const { return resident; }
+
+    void printReport(FILE* out = stdout) const {
+        static const char* names[] = { "textures", "fonts", "themes" };
+        std::fprintf(out, "%-10s %8s %12s %8s %10s\n", "class", "count", "bytes", "loads", "evictions");
+        for (size_t i = 0; i < static_cast<size_t>(ResourceClass::Count); ++i) {
+            const ResourceClassStats& s = classStats[i];
+            std::fprintf(out, "%-10s %8zu %12zu %8zu %10zu\n", names[i], s.count, s.bytes, s.loads, s.evictions);
+        }
+        std::fprintf(out, "resident %zu of %zu bytes\n", resident, budget);
+    }
+
+private:
+    friend class ResourceRef;
+
+    enum class State : uint8_t { Empty, Loading, Ready };
+
+    // Узлы unordered_map не переезжают - загрузчик держит указатель на запись до конца загрузки
+    struct Entry {
+        std::string id;
+        ResourceClass type = ResourceClass::Texture;
+        State state = State::Empty;
+        unsigned pins = 0;
+        uint64_t lastUse = 0;
+        size_t bytes = 0;
+        tgui::Texture texture; // страница: у спрайта атласа - общая GPU-текстура страницы
+        tgui::UIntRect part;   // прямоугольник ресурса на texture
+        std::string page;      // запись страницы атласа, которую держит спрайт
+        tgui::Font font;
+        tgui::Theme::Ptr theme;
+        std::vector<AssetReady> waiting;
+    };
+
+    Entry& lookup(const std::string& id, ResourceClass type) {
+        const std::string key = AssetPack::normalize(id);
+        Entry& entry = entries[key];
+        if (entry.id.empty()) {
+            entry.id = key;
+            entry.type = type;
+        }
+        entry.lastUse = ++useClock;
+        return entry;
+    }
+
+    // "textures/game/cup/glass_up.png" -> "cup/glass_up", если такой спрайт есть в атласе
+    std::string atlasName(const std::string& id) const {
+        if (!atlas || id.compare(0, atlasPrefix.size(), atlasPrefix) != 0) return {};
+        std::string name = id.substr(atlasPrefix.size());
+        const size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos) name.erase(dot);
+        return atlas->contains(name) ? name : std::string();
+    }
+
+    // Страница атласа от корня ассетов, как бы ни было загружено описание (из файла или из пака)
+    std::string pagePath(unsigned page) const {
+        return root + AssetPack::normalize(atlas->pageFile(page));
+    }
+
+    void loadTexture(Entry& entry) {
+        const std::string sprite = atlasName(entry.id);
+        if (!sprite.empty()) {
+            const AtlasRegion& r = *atlas->region(sprite);
+            Entry& page = lookup(atlas->pageFile(r.page), ResourceClass::Texture);
+            if (page.state != State::Ready) {
+                if (!pack || !pack->texture(pagePath(r.page), page.texture)) page.texture = tgui::Texture(pagePath(r.page));
+                page.part = wholeRect(page.texture);
+                finishLoad(page, textureBytes(page.texture));
+            }
+            finishSprite(entry, page, tgui::UIntRect(r.x, r.y, r.width, r.height));
+            return;
+        }
+        if (!pack || !pack->texture(entry.id, entry.texture)) entry.texture = tgui::Texture(root + entry.id);
+        entry.part = wholeRect(entry.texture);
+        finishLoad(entry, textureBytes(entry.texture));
+    }
+
+    void finishAsync(Entry& entry, const tgui::Texture& page, const tgui::UIntRect& part) {
+        std::vector<AssetReady> waiting;
+        waiting.swap(entry.waiting);
+        if (entry.state != State::Ready && (!part.width || !part.height)) {
+            // Загрузчик не смог - ждущие узнают об этом, запись снова пуста
+            entry.state = State::Empty;
+            for (AssetReady& onReady : waiting) onReady(tgui::Texture(), tgui::UIntRect());
+            return;
+        }
+
+        if (entry.state != State::Ready) {
+            if (const std::string sprite = atlasName(entry.id); !sprite.empty()) {
+                // Первый спрайт страницы заводит её запись; остальные получают ту же GPU-текстуру
+                Entry& pageEntry = lookup(atlas->pageFile(atlas->region(sprite)->page), ResourceClass::Texture);
+                if (pageEntry.state != State::Ready) {
+                    pageEntry.texture = page;
+                    pageEntry.part = wholeRect(page);
+                    finishLoad(pageEntry, textureBytes(page));
+                }
+                finishSprite(entry, pageEntry, part);
+            } else {
+                entry.texture = page;
+                entry.part = part;
+                finishLoad(entry, textureBytes(page));
+            }
+        }
+        for (AssetReady& onReady : waiting) onReady(entry.texture, entry.part);
+    }
+
+    // Спрайт - прямоугольник на странице: своей памяти нет, страница закреплена, пока спрайт в кэше
+    void finishSprite(Entry& entry, Entry& page, const tgui::UIntRect& part) {
+        entry.texture = page.texture;
+        entry.part = part;
+        entry.page = page.id;
+        ++page.pins;
+        finishLoad(entry, 0);
+    }
+
+    void finishLoad(Entry& entry, size_t bytes) {
+        ResourceClassStats& s = classStats[static_cast<size_t>(entry.type)];
+        entry.state = State::Ready;
+        entry.bytes = bytes;
+        ++s.count;
+        ++s.loads;
+        s.bytes += bytes;
+        resident += bytes;
+        ++entry.pins; // только что выданный ресурс не выгружается этим же trim
+        trim();
+        --entry.pins;
+    }
+
+    void evict(Entry& entry) {
+        ResourceClassStats& s = classStats[static_cast<size_t>(entry.type)];
+        --s.count;
+        ++s.evictions;
+        s.bytes -= entry.bytes;
+        resident -= entry.bytes;
+        const std::string page = entry.page;
+        entries.erase(entry.id);
+        if (!page.empty()) unpin(page);
+    }
+
+    void pin(const std::string& key) {
+        auto it = entries.find(key);
+        if (it != entries.end()) ++it->second.pins;
+    }
+
+    void unpin(const std::string& key) {
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.pins > 0) --it->second.pins;
+    }
+
+    static tgui::UIntRect wholeRect(const tgui::Texture& texture) {
+        const tgui::Vector2u size = texture.getImageSize();
+        return tgui::UIntRect(0, 0, size.x, size.y);
+    }
+
+    static size_t textureBytes(const tgui::Texture& texture) {
+        const tgui::Vector2u size = texture.getImageSize();
+        return static_cast<size_t>(size.x) * size.y * 4;
+    }
+
+    static size_t fileSize(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return 0;
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fclose(file);
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    std::unordered_map<std::string, Entry> entries;
+    ResourceClassStats classStats[static_cast<size_t>(ResourceClass::Count)];
+    size_t resident = 0;
+    size_t budget;
+    uint64_t useClock = 0;
+
+    const AssetPack* pack = nullptr;
+    const TextureAtlas* atlas = nullptr;
+    std::string atlasPrefix = "textures/game/";
+    AssetLoader* loader = nullptr;
+    std::string root = "./assets/";
+};
+
+inline ResourceRef::ResourceRef(ResourceCache* owner, std::string resourceId) : cache(owner), id(std::move(resourceId)) {
+    if (cache) cache->pin(id);
+}
+
+inline ResourceRef::~ResourceRef() {
+    if (cache) cache->unpin(id);
+}
+
+#endif
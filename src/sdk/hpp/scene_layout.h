@@ -0,0 +1,69 @@
+#ifndef SCENE_LAYOUT_H
+#define SCENE_LAYOUT_H
+
+#include <TGUI/TGUI.hpp>
+#include <algorithm>
+#include <cstddef>
+
+// Позиция виджета в пикселях исходной сцены
+struct WidgetPosition {
+    float x, y, width, height;
+};
+
+// Вписывание исходной сцены в окно: общий масштаб и поля по краям
+struct LayoutTransform {
+    float scale, offsetX, offsetY;
+
+    static LayoutTransform fit(float viewWidth, float viewHeight, float originalWidth, float originalHeight) {
+        const float scale = std::min(viewWidth / originalWidth, viewHeight / originalHeight);
+        return LayoutTransform{ scale, (viewWidth - originalWidth * scale) / 2.0f,
+                                (viewHeight - originalHeight * scale) / 2.0f };
+    }
+
+    void apply(const WidgetPosition& position, const tgui::Widget::Ptr& widget) const {
+        widget->setSize(position.width * scale, position.height * scale);
+        widget->setPosition(offsetX + position.x * scale, offsetY + position.y * scale);
+    }
+};
+
+// Игровой стол: исходные позиции в пикселях от 1024x512
+namespace SceneLayout {
+    constexpr float originalWidth = 1024.0f;
+    constexpr float originalHeight = 512.0f;
+
+    enum Slot : size_t {
+        CupPl1,
+        CupPl2,
+        LeftHandPl1,
+        RightHandPl1,
+        LeftHandPl2,
+        RightHandPl2,
+        Revolver,
+        MuzzleFlash,
+        BtnTap,
+        SlotCount
+    };
+
+    constexpr WidgetPosition positions[SlotCount] = {
+        {558, 426, 150, 150},  // cup_pl1
+        {467, 86, 150, 150},   // cup_pl2
+        {372, 446, 100, 100},  // left_hand_pl1
+        {652, 451, 100, 100},  // right_hand_pl1
+        {652, 106, 100, 100},  // left_hand_pl2
+        {372, 109, 100, 100},  // right_hand_pl2
+        {512, 340, 200, 54},   // revolver
+        {626, 332, 48, 48},    // muzzle_flash
+        {512, 256, 150, 70}    // btn_tap
+    };
+
+    // Расставить виджеты стола под размер окна; возвращает преобразование (масштаб нужен тексту)
+    inline LayoutTransform apply(float viewWidth, float viewHeight, const tgui::Widget::Ptr (&widgets)[SlotCount]) {
+        const LayoutTransform transform = LayoutTransform::fit(viewWidth, viewHeight, originalWidth, originalHeight);
+        for (size_t i = 0; i < SlotCount; ++i) {
+            transform.apply(positions[i], widgets[i]);
+        }
+        return transform;
+    }
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SFML/Graphics.hpp>
+#include <TGUI/TGUI.hpp>
+#include <TGUI/Backend/SFML-Graphics.hpp>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Слой игровых фишек под GUI: стаканы, руки, кости, пули - один sf::VertexArray вместо виджета TGUI на каждую.
+// Положение спрайта - прямоугольник его узла: tgui::Widget вне Gui, его двигают AnimationSystem и LayoutSystem,
+// но TGUI его не рисует и не прогоняет через события. sync() раз в кадр забирает трансформы всех узлов разом
+// и перестраивает вершины, только если что-то сдвинулось. Спрайты одной GPU-текстуры (страница атласа) -
+// один draw-вызов; без атласа - по вызову на каждую смену текстуры в порядке добавления.
+class SpriteBatch {
+public:
+    using Sprite = uint32_t;
+
+    // Узел спрайта: только трансформ (позиция, размер, origin, поворот, видимость)
+    static tgui::Widget::Ptr createNode() {
+        return tgui::ClickableWidget::create();
+    }
+
+    Sprite add(const tgui::Widget::Ptr& node) {
+        nodes.push_back(node);
+        images.emplace_back();
+        transforms.emplace_back();
+        dirty = true;
+        return static_cast<Sprite>(nodes.size() - 1);
+    }
+
+    // Картинка спрайта: страница (GPU-текстура, как её отдаёт AssetLoader) и прямоугольник на ней;
+    // пустой part - прямоугольник самой tgui::Texture. Без картинки спрайт не рисуется
+    void setImage(Sprite sprite, const tgui::Texture& page, const tgui::UIntRect& part = {}) {
+        Image& image = images[sprite];
+        image.texture = page; // держит GPU-текстуру живой
+        image.native = nativeTexture(page);
+        image.rect = part.width && part.height ? part : imageRect(page);
+        dirty = true;
+    }
+
+    // Другой прямоугольник той же текстуры (кадр анимации) - меняются только UV
+    void setFrame(Sprite sprite, const tgui::UIntRect& rect) {
+        images[sprite].rect = rect;
+        dirty = true;
+    }
+
+    const tgui::Widget::Ptr& node(Sprite sprite) const { return nodes[sprite]; }
+    size_t size() const { return nodes.size(); }
+
+    // Раз в кадр после анимаций и раскладки; true - картинка слоя изменилась
+    bool sync() {
+        bool changed = dirty;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const tgui::Widget& widget = *nodes[i];
+            const Transform now{ widget.getPosition(), widget.getSize(), widget.getOrigin(), widget.getRotation(),
+                                 widget.isVisible() };
+            if (!same(now, transforms[i])) {
+                transforms[i] = now;
+                changed = true;
+            }
+        }
+        if (!changed) return false;
+
+        dirty = false;
+        rebuild();
+        return true;
+    }
+
+    // Под gui.draw(); view - gui.getView(), чтобы координаты узлов совпадали с виджетами
+    void draw(sf::RenderTarget& target, const tgui::FloatRect& view) const {
+        if (runs.empty()) return;
+        const sf::View previous = target.getView();
+        target.setView(sf::View(sf::FloatRect({ view.left, view.top }, { view.width, view.height })));
+        for (const Run& run : runs) {
+            sf::RenderStates states;
+            states.texture = run.texture;
+            target.draw(&vertices[run.first], run.count, sf::PrimitiveType::Triangles, states);
+        }
+        target.setView(previous);
+    }
+
+    size_t drawCalls() const { return runs.size(); }
+
+    // Прямоугольник tgui::Texture на её GPU-текстуре: заданный кусок или вся картинка
+    static tgui::UIntRect imageRect(const tgui::Texture& texture) {
+        const tgui::UIntRect part = texture.getPartRect();
+        if (part.width && part.height) return part;
+        const tgui::Vector2u size = texture.getImageSize();
+        return tgui::UIntRect(0, 0, size.x, size.y);
+    }
+
+    // TGUI держит картинку целиком, даже если у tgui::Texture задан прямоугольник, - атлас остаётся одной текстурой
+    static const sf::Texture* nativeTexture(const tgui::Texture& texture) {
+        const std::shared_ptr<tgui::TextureData> data = texture.getData();
+        if (!data || !data->backendTexture) return nullptr;
+        return &std::static_pointer_cast<tgui::BackendTextureSFML>(data->backendTexture)->getInternalTexture();
+    }
+
+private:
+    struct Image {
+        tgui::Texture texture;
+        const sf::Texture* native = nullptr;
+        tgui::UIntRect rect;
+    };
+
+    struct Transform {
+        tgui::Vector2f position, size, origin;
+        float rotation = 0; // градусы по часовой вокруг origin, как у tgui::Widget
+        bool visible = false;
+    };
+
+    // Отрезок вершин с одной текстурой
+    struct Run {
+        const sf::Texture* texture;
+        size_t first, count;
+    };
+
+    static bool same(const Transform& a, const Transform& b) {
+        return a.visible == b.visible && a.position.x == b.position.x && a.position.y == b.position.y &&
+               a.size.x == b.size.x && a.size.y == b.size.y && a.origin.x == b.origin.x && a.origin.y == b.origin.y &&
+               a.rotation == b.rotation;
+    }
+
+    void rebuild() {
+        vertices.clear();
+        runs.clear();
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const Transform& t = transforms[i];
+            const Image& image = images[i];
+            if (!t.visible || !image.native) continue;
+
+            if (runs.empty() || runs.back().texture != image.native) {
+                runs.push_back(Run{ image.native, vertices.getVertexCount(), 0 });
+            }
+
+            // Углы относительно origin, поворот вокруг него же
+            const float left = -t.origin.x * t.size.x;
+            const float top = -t.origin.y * t.size.y;
+            const float right = left + t.size.x;
+            const float bottom = top + t.size.y;
+            const float radians = t.rotation * 3.14159265f / 180;
+            const float c = t.rotation != 0 ? std::cos(radians) : 1.0f;
+            const float s = t.rotation != 0 ? std::sin(radians) : 0.0f;
+            const auto at = [&](float x, float y) {
+                return sf::Vector2f{ t.position.x + x * c - y * s, t.position.y + x * s + y * c };
+            };
+            const float u0 = static_cast<float>(image.rect.left);
+            const float v0 = static_cast<float>(image.rect.top);
+            const float u1 = u0 + static_cast<float>(image.rect.width);
+            const float v1 = v0 + static_cast<float>(image.rect.height);
+
+            const sf::Vertex quad[6] = {
+                { at(left, top), sf::Color::White, { u0, v0 } },
+                { at(right, top), sf::Color::White, { u1, v0 } },
+                { at(left, bottom), sf::Color::White, { u0, v1 } },
+                { at(left, bottom), sf::Color::White, { u0, v1 } },
+                { at(right, top), sf::Color::White, { u1, v0 } },
+                { at(right, bottom), sf::Color::White, { u1, v1 } },
+            };
+            for (const sf::Vertex& vertex : quad) vertices.append(vertex);
+            runs.back().count += 6;
+        }
+    }
+
+    std::vector<tgui::Widget::Ptr> nodes;
+    std::vector<Image> images;
+    std::vector<Transform> transforms;
+    sf::VertexArray vertices{ sf::PrimitiveType::Triangles };
+    std::vector<Run> runs;
+    bool dirty = false;
+};
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <TGUI/TGUI.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Атлас спрайтов: все картинки игры упакованы в одну-две страницы (tools/pack_atlas.cpp),
+// виджеты получают tgui::Texture(файл страницы, прямоугольник). TGUI кэширует текстуру по имени файла,
+// поэтому все Picture одной страницы делят одну GPU-текстуру - меньше переключений текстур за кадр.
+
+// Прямоугольник спрайта на странице атласа
+struct AtlasRegion {
+    unsigned page;
+    unsigned x, y, width, height;
+};
+
+// Упаковка полками: спрайты кладутся слева направо в ряды высотой по самому высокому.
+// Быстро и почти без потерь, если входы отсортированы по убыванию высоты.
+class ShelfPacker {
+public:
+    ShelfPacker(unsigned pageWidth, unsigned pageHeight, unsigned spritePadding = 2)
+        : width(pageWidth), height(pageHeight), padding(spritePadding) {}
+
+    // Левый верхний угол места под w x h; false - на странице не хватает места
+    bool insert(unsigned w, unsigned h, unsigned& outX, unsigned& outY) {
+        const unsigned paddedW = w + padding;
+        const unsigned paddedH = h + padding;
+        if (paddedW > width || paddedH > height) return false;
+
+        // Полка с наименьшей лишней высотой, где хватает ширины
+        Shelf* best = nullptr;
+        for (Shelf& shelf : shelves) {
+            if (shelf.height >= paddedH && width - shelf.used >= paddedW) {
+                if (!best || shelf.height < best->height) best = &shelf;
+            }
+        }
+
+        if (!best) {
+            if (height - top < paddedH) return false;
+            shelves.push_back({ top, paddedH, 0 });
+            top += paddedH;
+            best = &shelves.back();
+        }
+
+        outX = best->used;
+        outY = best->y;
+        best->used += paddedW;
+        return true;
+    }
+
+    // Доля площади страницы под спрайтами (с отступами)
+    float occupancy() const {
+        unsigned long long used = 0;
+        for (const Shelf& shelf : shelves) used += static_cast<unsigned long long>(shelf.used) * shelf.height;
+        return static_cast<float>(used) / (static_cast<float>(width) * height);
+    }
+
+private:
+    struct Shelf {
+        unsigned y, height, used;
+    };
+
+    unsigned width, height, padding;
+    unsigned top = 0;
+    std::vector<Shelf> shelves;
+};
+
+// Размещение набора спрайтов по страницам; порядок входа не важен.
+// Спрайты с одинаковым group != 0 (кадры одного клипа, виды частиц одной системы) попадают на одну страницу целиком.
+struct AtlasLayout {
+    struct Input {
+        std::string name;
+        unsigned width, height;
+        unsigned group = 0;
+    };
+
+    std::vector<AtlasRegion> regions; // в порядке входа
+    unsigned pages = 0;
+
+    // Папки, которые рисует одна система частиц (все виды - с одной текстуры): гильзы pistol/patron.
+    // Остальные папки не группируются - кадры револьвера, например, на одну страницу 2048 не влезают
+    static std::vector<std::string> defaultGroups() {
+        return { "pistol/patron" };
+    }
+
+    // Спрайты names - на одну страницу; группа, задевающая уже собранную, сливается с ней.
+    // Возвращает число имён, которых нет среди sprites
+    static size_t group(std::vector<Input>& sprites, const std::vector<std::string>& names) {
+        unsigned group = 0;
+        for (const Input& in : sprites) group = std::max(group, in.group);
+        ++group;
+
+        size_t missing = 0;
+        for (const std::string& name : names) {
+            auto input = std::find_if(sprites.begin(), sprites.end(), [&](const Input& in) { return in.name == name; });
+            if (input == sprites.end()) {
+                ++missing;
+                continue;
+            }
+            if (input->group != 0 && input->group != group) {
+                const unsigned merged = input->group;
+                for (Input& in : sprites) {
+                    if (in.group == merged) in.group = group;
+                }
+            }
+            input->group = group;
+        }
+        return missing;
+    }
+
+    // Все спрайты папки folder ("pistol/patron", без вложенных) - на одну страницу; false - в папке нет спрайтов
+    static bool groupFolder(std::vector<Input>& sprites, const std::string& folder) {
+        std::vector<std::string> names;
+        for (const Input& in : sprites) {
+            const size_t slash = in.name.find_last_of('/');
+            if (slash != std::string::npos && in.name.compare(0, slash, folder) == 0 && slash == folder.size()) {
+                names.push_back(in.name);
+            }
+        }
+        group(sprites, names);
+        return !names.empty();
+    }
+
+    // false - какой-то спрайт или группа больше страницы
+    static bool build(const std::vector<Input>& sprites, unsigned pageSize, unsigned padding, AtlasLayout& out) {
+        auto higher = [&](size_t a, size_t b) {
+            if (sprites[a].height != sprites[b].height) return sprites[a].height > sprites[b].height;
+            return sprites[a].width > sprites[b].width;
+        };
+
+        // Единица упаковки - одиночный спрайт или вся группа, по убыванию самого высокого спрайта
+        std::vector<std::vector<size_t>> units;
+        std::unordered_map<unsigned, size_t> groupUnit;
+        for (size_t i = 0; i < sprites.size(); ++i) {
+            if (sprites[i].group == 0) {
+                units.push_back({ i });
+                continue;
+            }
+            auto it = groupUnit.emplace(sprites[i].group, units.size()).first;
+            if (it->second == units.size()) units.emplace_back();
+            units[it->second].push_back(i);
+        }
+        for (std::vector<size_t>& unit : units) std::sort(unit.begin(), unit.end(), higher);
+        std::stable_sort(units.begin(), units.end(), [&](const std::vector<size_t>& a, const std::vector<size_t>& b) {
+            return higher(a.front(), b.front());
+        });
+
+        out.regions.assign(sprites.size(), AtlasRegion{});
+        out.pages = 0;
+        std::vector<ShelfPacker> packers;
+
+        // Группа ставится на копию упаковщика и принимается, только если влезла вся
+        auto place = [&](ShelfPacker& packer, const std::vector<size_t>& unit, unsigned page) {
+            ShelfPacker trial = packer;
+            for (size_t index : unit) {
+                AtlasRegion& region = out.regions[index];
+                region.page = page;
+                region.width = sprites[index].width;
+                region.height = sprites[index].height;
+                if (!trial.insert(region.width, region.height, region.x, region.y)) return false;
+            }
+            packer = trial;
+            return true;
+        };
+
+        for (const std::vector<size_t>& unit : units) {
+            bool placed = false;
+            for (size_t page = 0; page < packers.size() && !placed; ++page) {
+                placed = place(packers[page], unit, static_cast<unsigned>(page));
+            }
+            if (!placed) {
+                packers.emplace_back(pageSize, pageSize, padding);
+                if (!place(packers.back(), unit, static_cast<unsigned>(packers.size() - 1))) return false;
+            }
+        }
+        out.pages = static_cast<unsigned>(packers.size());
+        return true;
+    }
+};
+
+// Описание атласа в текстовом файле рядом со страницами; имя - до конца строки (в именах бывают пробелы):
+//   page <индекс> <файл страницы>
+//   sprite <страница> <x> <y> <ширина> <высота> <имя>
+class TextureAtlas {
+public:
+    // Путь файла страницы относительно каталога описания
+    bool load(const std::string& manifestPath) {
+        FILE* file = std::fopen(manifestPath.c_str(), "rb");
+        if (!file) return false;
+        std::string text;
+        char chunk[4096];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) text.append(chunk, read);
+        std::fclose(file);
+
+        const size_t slash = manifestPath.find_last_of("/\\");
+        return parse(text.data(), text.size(), slash == std::string::npos ? std::string() : manifestPath.substr(0, slash + 1));
+    }
+
+    // Описание из памяти (например, из пака ассетов); directory приписывается к именам страниц
+    bool parse(const char* text, size_t size, const std::string& directory) {
+        pageFiles.clear();
+        sprites.clear();
+        unsigned page, x, y, w, h;
+        int nameStart = 0;
+        std::string line;
+        for (size_t begin = 0; begin < size;) {
+            size_t end = begin;
+            while (end < size && text[end] != '\n') ++end;
+            line.assign(text + begin, end - begin);
+            begin = end + 1;
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+
+            if (std::sscanf(line.c_str(), "page %u %n", &page, &nameStart) == 1 && nameStart > 0) {
+                if (pageFiles.size() <= page) pageFiles.resize(page + 1);
+                pageFiles[page] = directory + line.substr(static_cast<size_t>(nameStart));
+            } else if (std::sscanf(line.c_str(), "sprite %u %u %u %u %u %n", &page, &x, &y, &w, &h, &nameStart) == 5 && nameStart > 0) {
+                sprites[line.substr(static_cast<size_t>(nameStart))] = AtlasRegion{ page, x, y, w, h };
+            }
+            nameStart = 0;
+        }
+        return !pageFiles.empty();
+    }
+
+    static bool save(const std::string& manifestPath, const std::vector<std::string>& pageNames,
+                     const std::vector<AtlasLayout::Input>& inputs, const AtlasLayout& layout) {
+        FILE* file = std::fopen(manifestPath.c_str(), "w");
+        if (!file) return false;
+        for (size_t page = 0; page < pageNames.size(); ++page) {
+            std::fprintf(file, "page %zu %s\n", page, pageNames[page].c_str());
+        }
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const AtlasRegion& r = layout.regions[i];
+            std::fprintf(file, "sprite %u %u %u %u %u %s\n", r.page, r.x, r.y, r.width, r.height, inputs[i].name.c_str());
+        }
+        std::fclose(file);
+        return true;
+    }
+
+    bool contains(const std::string& name) const { return sprites.count(name) != 0; }
+
+    const AtlasRegion* region(const std::string& name) const {
+        auto it = sprites.find(name);
+        return it == sprites.end() ? nullptr : &it->second;
+    }
+
+    const std::string& pageFile(unsigned page) const { return pageFiles[page]; }
+    size_t pageCount() const { return pageFiles.size(); }
+
+    // Текстура спрайта из атласа; без атласа (не собран) - отдельный файл fallbackPath
+    tgui::Texture texture(const std::string& name, const std::string& fallbackPath) const {
+        const AtlasRegion* r = region(name);
+        if (!r || r->page >= pageFiles.size()) return tgui::Texture(fallbackPath);
+        return tgui::Texture(pageFiles[r->page], tgui::UIntRect(r->x, r->y, r->width, r->height));
+    }
+
+private:
+    std::vector<std::string> pageFiles;
+    std::unordered_map<std::string, AtlasRegion> sprites;
+};
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "inline_function.h"
+
+// Callback таймера хранится в записи колеса без аллокаций
+using TimerCallback = InlineFunction<void()>;
+
+// Дескриптор таймера: слот + поколение, как у AnimationHandle
+struct TimerHandle {
+    static constexpr uint32_t invalidSlot = 0xFFFFFFFFu;
+
+    uint32_t slot = invalidSlot;
+    uint32_t generation = 0;
+
+    bool valid() const { return slot != invalidSlot; }
+};
+
+// Иерархическое колесо таймеров (4 уровня по 64 ячейки), крутится из главного цикла.
+// Вставка и отмена - O(1); advance() перескакивает пустые тики по маске занятых ячеек,
+// дальние таймеры спускаются на нижний уровень, когда до них доходит очередь.
+// Не потокобезопасно: планировать и крутить колесо нужно из одного (UI) потока.
+class TimerWheel {
+public:
+    static constexpr int levelBits = 6;
+    static constexpr int levels = 4;
+    static constexpr uint32_t slotsPerLevel = 1u << levelBits;
+
+    explicit TimerWheel(double tickSeconds = 0.001) : tick(tickSeconds) {
+        for (auto& level : wheel) {
+            for (auto& slot : level) {
+                slot = Bucket{ none, none };
+            }
+        }
+    }
+
+    // callback через delay секунд от последнего advance(); interval > 0 - повтор с этим шагом
+    TimerHandle schedule(double delay, TimerCallback callback, double interval = 0) {
+        return scheduleAt(lastTime + std::max(delay, 0.0), std::move(callback), interval);
+    }
+
+    // callback в момент time (в тех же секундах, что и advance())
+    TimerHandle scheduleAt(double time, TimerCallback callback, double interval = 0) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(entries.size());
+            entries.emplace_back();
+        }
+
+        Entry& e = entries[slot];
+        e.callback = std::move(callback);
+        e.due = toTick(std::max(time, lastTime));
+        e.interval = interval > 0 ? std::max<uint64_t>(1, toTick(interval)) : 0;
+        e.active = true;
+        ++active;
+        if (e.due < earliest) earliest = e.due;
+
+        link(slot);
+        return TimerHandle{ slot, e.generation };
+    }
+
+    bool cancel(TimerHandle handle) {
+        if (!pending(handle)) return false;
+        unlink(handle.slot);
+        release(handle.slot);
+        return true;
+    }
+
+    bool pending(TimerHandle handle) const {
+        return handle.valid() && handle.slot < entries.size() &&
+               entries[handle.slot].generation == handle.generation && entries[handle.slot].active;
+    }
+
+    size_t size() const { return active; }
+
+    // Довести колесо до момента now (секунды) и вызвать всё, что наступило.
+    // Callback может планировать новые таймеры - они сработают не раньше следующего тика.
+    // Возвращает число вызванных callback'ов (0 - кадр таймерами не менялся).
+    size_t advance(double now) {
+        if (now < lastTime) return 0;
+        lastTime = now;
+
+        const uint64_t target = static_cast<uint64_t>(now / tick);
+        if (active == 0) {
+            current = target + 1;
+            return 0;
+        }
+
+        size_t fired = 0;
+
+        while (current <= target) {
+            const uint32_t index = current & (slotsPerLevel - 1);
+            if (index == 0) {
+                for (int level = 1; level < levels && cascade(level) == 0; ++level) {}
+            }
+
+            // Пустые тики не обходим: сразу к ближайшей занятой ячейке или к границе каскада
+            const uint64_t ahead = occupied[0] >> index;
+            const uint64_t skip = ahead ? lowestBit(ahead) : slotsPerLevel - index;
+            if (skip != 0) {
+                current = std::min(current + skip, target + 1);
+                continue;
+            }
+
+            // Снимаем ячейку целиком до вызовов - callback может трогать колесо
+            Bucket& bucket = wheel[0][index];
+            for (uint32_t slot = bucket.head; slot != none;) {
+                Entry& e = entries[slot];
+                firing.push_back(Firing{ slot, e.generation });
+                const uint32_t next = e.next;
+                e.prev = e.next = none;
+                e.level = detached;
+                slot = next;
+            }
+            bucket = Bucket{ none, none };
+            occupied[0] &= ~(uint64_t(1) << index);
+            ++current;
+
+            for (const Firing& f : firing) {
+                // Мог быть отменён callback'ом из той же ячейки
+                if (entries[f.slot].generation == f.generation && entries[f.slot].active) {
+                    fire(f.slot);
+                    ++fired;
+                }
+            }
+            firing.clear();
+        }
+        return fired;
+    }
+
+    // Момент ближайшего срабатывания (в секундах advance()); таймеров нет - HUGE_VAL.
+    // Кэшируется: перебор записей только после того, как ушёл сам ближайший таймер
+    double nextTime() const {
+        if (earliestStale) {
+            earliest = UINT64_MAX;
+            for (const Entry& e : entries) {
+                if (e.active && e.due < earliest) earliest = e.due;
+            }
+            earliestStale = false;
+        }
+        return earliest == UINT64_MAX ? HUGE_VAL : static_cast<double>(earliest) * tick;
+    }
+
+    void clear() {
+        for (uint32_t slot = 0; slot < entries.size(); ++slot) {
+            if (entries[slot].active) {
+                unlink(slot);
+                release(slot);
+            }
+        }
+    }
+
+    // clear() + отсчёт времени с нуля: для перезапуска часов, которыми крутится колесо
+    void reset() {
+        clear();
+        lastTime = 0;
+        current = 0;
+        earliest = UINT64_MAX;
+        earliestStale = false;
+    }
+
+private:
+    static constexpr uint32_t none = 0xFFFFFFFFu;
+    static constexpr uint8_t detached = 0xFF; // снят с колеса и ждёт вызова
+
+    struct Entry {
+        TimerCallback callback;
+        uint64_t due = 0;
+        uint64_t interval = 0;
+        uint32_t prev = none, next = none;
+        uint32_t generation = 0;
+        uint8_t level = 0, index = 0;
+        bool active = false;
+    };
+
+    struct Bucket {
+        uint32_t head, tail;
+    };
+
+    struct Firing {
+        uint32_t slot, generation;
+    };
+
+    // Номер младшего установленного бита (x != 0), де Брёйн - без интринсиков
+    static uint32_t lowestBit(uint64_t x) {
+        static constexpr uint8_t table[64] = {
+            0,  1,  48, 2,  57, 49, 28, 3,  61, 58, 50, 42, 38, 29, 17, 4,
+            62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+            63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+            46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9,  13, 8,  7,  6,
+        };
+        return table[((x & (~x + 1)) * 0x03f79d71b4cb0a89ull) >> 58];
+    }
+
+    uint64_t toTick(double seconds) const {
+        return static_cast<uint64_t>(std::ceil(seconds / tick - 1e-9));
+    }
+
+    void fire(uint32_t slot) {
+        Entry& e = entries[slot];
+
+        // Дальше горизонта колеса таймер кладётся на верхний уровень заранее - дожидаемся срока
+        if (e.due >= current) {
+            link(slot);
+            return;
+        }
+
+        if (e.interval) {
+            if (e.due <= earliest) earliestStale = true;
+            e.due += e.interval;
+            if (e.due < current) e.due = current;
+            link(slot);
+
+            // callback может отменить свой же таймер - тогда не возвращаем его на место
+            const uint32_t generation = e.generation;
+            TimerCallback callback = std::move(e.callback);
+            callback();
+            if (entries[slot].generation == generation) {
+                entries[slot].callback = std::move(callback);
+            }
+            return;
+        }
+
+        TimerCallback callback = std::move(e.callback);
+        release(slot);
+        callback();
+    }
+
+    // Перенос ячейки уровня вниз; возвращает индекс ячейки (0 - пора переносить и следующий уровень)
+    uint32_t cascade(int level) {
+        const uint32_t index = static_cast<uint32_t>(current >> (level * levelBits)) & (slotsPerLevel - 1);
+        Bucket& bucket = wheel[level][index];
+        uint32_t slot = bucket.head;
+        bucket = Bucket{ none, none };
+        occupied[level] &= ~(uint64_t(1) << index);
+        while (slot != none) {
+            const uint32_t next = entries[slot].next;
+            link(slot);
+            slot = next;
+        }
+        return index;
+    }
+
+    void link(uint32_t slot) {
+        Entry& e = entries[slot];
+        const uint64_t delta = e.due > current ? e.due - current : 0;
+        const uint64_t due = e.due > current ? e.due : current;
+
+        int level = 0;
+        while (level + 1 < levels && delta >= (uint64_t(1) << ((level + 1) * levelBits))) {
+            ++level;
+        }
+        // Дальше горизонта - в самую дальнюю ячейку верхнего уровня, оттуда вернётся через fire()
+        const uint64_t horizon = (uint64_t(1) << (levels * levelBits)) - 1;
+        const uint64_t placed = delta > horizon ? current + horizon : due;
+
+        e.level = static_cast<uint8_t>(level);
+        e.index = static_cast<uint8_t>((placed >> (level * levelBits)) & (slotsPerLevel - 1));
+
+        Bucket& bucket = wheel[level][e.index];
+        e.prev = bucket.tail;
+        e.next = none;
+        if (bucket.tail != none) entries[bucket.tail].next = slot;
+        else bucket.head = slot;
+        bucket.tail = slot;
+        occupied[level] |= uint64_t(1) << e.index;
+    }
+
+    void unlink(uint32_t slot) {
+        Entry& e = entries[slot];
+        if (e.level == detached) return;
+        Bucket& bucket = wheel[e.level][e.index];
+        if (e.prev != none) entries[e.prev].next = e.next;
+        else if (bucket.head == slot) bucket.head = e.next;
+        if (e.next != none) entries[e.next].prev = e.prev;
+        else if (bucket.tail == slot) bucket.tail = e.prev;
+        if (bucket.head == none) occupied[e.level] &= ~(uint64_t(1) << e.index);
+        e.prev = e.next = none;
+    }
+
+    void release(uint32_t slot) {
+        Entry& e = entries[slot];
+        if (e.due <= earliest) earliestStale = true;
+        e.callback = nullptr;
+        e.active = false;
+        ++e.generation;
+        --active;
+        freeSlots.push_back(slot);
+    }
+
+    double tick;
+    double lastTime = 0;
+    uint64_t current = 0;
+    size_t active = 0;
+    Bucket wheel[levels][slotsPerLevel];
+    uint64_t occupied[levels] = {}; // бит на непустую ячейку уровня
+    mutable uint64_t earliest = UINT64_MAX;
+    mutable bool earliestStale = false;
+    std::vector<Entry> entries;
+    std::vector<uint32_t> freeSlots;
+    std::vector<Firing> firing;
+};
+
+#endif
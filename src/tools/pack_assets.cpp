@@ -0,0 +1,152 @@
+// Сборка пака ассетов для AssetPack
+//   pack_assets [--input DIR] [--output FILE] [--raw-images]
+// Все файлы из DIR (по умолчанию ./assets) складываются в FILE (по умолчанию ./assets.pak).
+// Картинки (.png, .jpg, .bmp, .tga) раскодируются в RGBA заранее; остальное и то,
+// что SFML не раскодирует (например .webp), хранится как есть. Имя записи - путь от DIR в UTF-8.
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../sdk/hpp/asset_pack.h"
+
+static void usage() {
+    std::printf("usage: pack_assets [--input DIR] [--output FILE] [--raw-images]\n");
+}
+
+struct PackItem {
+    std::string name;            // UTF-8, через '/'
+    std::vector<uint8_t> bytes;
+    AssetPackType type = AssetPackType::Raw;
+    uint32_t width = 0, height = 0;
+};
+
+static bool isImage(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tga";
+}
+
+// Читается через path, а не через узкую строку - кириллические имена открываются и под Windows
+static bool readFile(const std::filesystem::path& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + AssetPack::alignment - 1) & ~(AssetPack::alignment - 1);
+}
+
+int main(int argc, char** argv) {
+    std::string inputDir = "./assets";
+    std::string outputPath = "./assets.pak";
+    bool rawImages = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--input") && hasValue) {
+            inputDir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--raw-images")) {
+            rawImages = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code error;
+    if (!fs::is_directory(inputDir, error)) {
+        std::fprintf(stderr, "no input directory %s\n", inputDir.c_str());
+        return 1;
+    }
+
+    std::vector<PackItem> items;
+    uint64_t sourceBytes = 0;
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(inputDir)) {
+        if (!entry.is_regular_file()) continue;
+
+        PackItem item;
+        const auto name = fs::relative(entry.path(), inputDir).generic_u8string();
+        item.name.assign(name.begin(), name.end());
+        if (!readFile(entry.path(), item.bytes)) {
+            std::fprintf(stderr, "cannot read %s\n", item.name.c_str());
+            return 1;
+        }
+        sourceBytes += item.bytes.size();
+
+        sf::Image image;
+        if (!rawImages && isImage(entry.path()) && image.loadFromMemory(item.bytes.data(), item.bytes.size())) {
+            const sf::Vector2u size = image.getSize();
+            item.type = AssetPackType::Image;
+            item.width = size.x;
+            item.height = size.y;
+            item.bytes.assign(image.getPixelsPtr(), image.getPixelsPtr() + static_cast<size_t>(size.x) * size.y * 4);
+        }
+        items.push_back(std::move(item));
+    }
+
+    // Оглавление сортируется побайтово - так же сравнивает AssetPack::find
+    std::sort(items.begin(), items.end(), [](const PackItem& a, const PackItem& b) { return a.name < b.name; });
+
+    AssetPackHeader header{};
+    std::memcpy(header.magic, AssetPack::magic, 4);
+    header.version = AssetPack::version;
+    header.entryCount = static_cast<uint32_t>(items.size());
+
+    std::vector<AssetPackEntry> entries(items.size());
+    uint64_t cursor = sizeof(AssetPackHeader) + entries.size() * sizeof(AssetPackEntry);
+    for (size_t i = 0; i < items.size(); ++i) {
+        entries[i].nameOffset = static_cast<uint32_t>(cursor);
+        entries[i].nameLength = static_cast<uint32_t>(items[i].name.size());
+        cursor += items[i].name.size();
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        cursor = alignUp(cursor);
+        entries[i].offset = cursor;
+        entries[i].size = items[i].bytes.size();
+        entries[i].type = items[i].type;
+        entries[i].width = items[i].width;
+        entries[i].height = items[i].height;
+        cursor += items[i].bytes.size();
+    }
+
+    std::ofstream out(fs::u8path(outputPath), std::ios::binary);
+    if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", outputPath.c_str());
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(AssetPackEntry)));
+    for (const PackItem& item : items) {
+        out.write(item.name.data(), static_cast<std::streamsize>(item.name.size()));
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        const std::streamoff position = out.tellp();
+        static const char zeros[AssetPack::alignment] = {};
+        out.write(zeros, static_cast<std::streamsize>(entries[i].offset - static_cast<uint64_t>(position)));
+        out.write(reinterpret_cast<const char*>(items[i].bytes.data()), static_cast<std::streamsize>(items[i].bytes.size()));
+    }
+    if (!out) {
+        std::fprintf(stderr, "write failed: %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    size_t images = 0;
+    for (const PackItem& item : items) images += item.type == AssetPackType::Image;
+    std::printf("%zu files (%zu images decoded), %llu -> %llu bytes: %s\n", items.size(), images,
+                (unsigned long long)sourceBytes, (unsigned long long)cursor, outputPath.c_str());
+    return 0;
+}
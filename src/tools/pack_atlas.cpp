@@ -0,0 +1,138 @@
+// Упаковка спрайтов игры в атлас
+//   pack_atlas [--input DIR] [--output DIR] [--page-size N] [--padding P] [--clips FILE] [--group FOLDER]...
+// Все .png из DIR (по умолчанию ./assets/textures/game) раскладываются по страницам N x N,
+// в --output пишутся atlas_<страница>.png и atlas.txt для TextureAtlas::load.
+// Имя спрайта - путь от DIR без расширения: "hands/hand_blue".
+// Кадры одного клипа из --clips (по умолчанию ./assets/animations/clips.txt, если есть) кладутся на одну
+// страницу - FrameAnimator меняет кадр только UV-прямоугольником. Спрайты папки --group (без него -
+// AtlasLayout::defaultGroups(), гильзы) тоже на одной странице - все виды частиц системы с одной текстуры.
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../sdk/hpp/frame_animation.h"
+#include "../sdk/hpp/texture_atlas.h"
+
+static void usage() {
+    std::printf("usage: pack_atlas [--input DIR] [--output DIR] [--page-size N] [--padding P] [--clips FILE] [--group FOLDER]...\n");
+}
+
+int main(int argc, char** argv) {
+    std::string inputDir = "./assets/textures/game";
+    std::string outputDir = "./assets/textures/atlas";
+    unsigned pageSize = 2048;
+    unsigned padding = 2;
+    std::string clipsPath = "./assets/animations/clips.txt";
+    std::vector<std::string> groupFolders;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--input") && hasValue) {
+            inputDir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--output") && hasValue) {
+            outputDir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--page-size") && hasValue) {
+            pageSize = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!std::strcmp(argv[i], "--padding") && hasValue) {
+            padding = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!std::strcmp(argv[i], "--clips") && hasValue) {
+            clipsPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--group") && hasValue) {
+            groupFolders.push_back(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code error;
+    if (!fs::is_directory(inputDir, error)) {
+        std::fprintf(stderr, "no input directory %s\n", inputDir.c_str());
+        return 1;
+    }
+
+    // Порядок обхода каталога не определён - сортируем, чтобы атлас собирался одинаково
+    std::vector<fs::path> files;
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(inputDir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".png") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<sf::Image> images(files.size());
+    std::vector<AtlasLayout::Input> inputs;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!images[i].loadFromFile(files[i].string())) {
+            std::fprintf(stderr, "cannot load %s\n", files[i].string().c_str());
+            return 1;
+        }
+        fs::path name = fs::relative(files[i], inputDir);
+        name.replace_extension();
+        inputs.push_back({ name.generic_string(), images[i].getSize().x, images[i].getSize().y });
+    }
+
+    // Группа страницы на клип и на папку --group; спрайт из нескольких групп сливает их в одну
+    std::vector<FrameClipSource> clips;
+    FrameClipSource::load(clipsPath, clips);
+    for (const FrameClipSource& clip : clips) {
+        std::vector<std::string> frames;
+        for (const FrameClipSource::Frame& frame : clip.frames) frames.push_back(frame.sprite);
+        if (const size_t missing = AtlasLayout::group(inputs, frames)) {
+            std::fprintf(stderr, "clip %s: %zu sprite(s) not found\n", clip.name.c_str(), missing);
+        }
+    }
+    if (groupFolders.empty()) groupFolders = AtlasLayout::defaultGroups();
+    for (const std::string& folder : groupFolders) {
+        if (!AtlasLayout::groupFolder(inputs, folder)) std::fprintf(stderr, "group %s: no sprites\n", folder.c_str());
+    }
+
+    AtlasLayout layout;
+    if (!AtlasLayout::build(inputs, pageSize, padding, layout)) {
+        std::fprintf(stderr, "sprite, group or clip larger than page %ux%u\n", pageSize, pageSize);
+        return 1;
+    }
+
+    // Страница обрезается по занятой высоте и ширине - меньше видеопамяти
+    std::vector<sf::Vector2u> pageExtent(layout.pages, { 1, 1 });
+    for (const AtlasRegion& r : layout.regions) {
+        pageExtent[r.page].x = std::max(pageExtent[r.page].x, r.x + r.width);
+        pageExtent[r.page].y = std::max(pageExtent[r.page].y, r.y + r.height);
+    }
+
+    fs::create_directories(outputDir, error);
+    std::vector<std::string> pageNames;
+    for (unsigned page = 0; page < layout.pages; ++page) {
+        sf::Image pageImage(pageExtent[page], sf::Color::Transparent);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const AtlasRegion& r = layout.regions[i];
+            if (r.page != page) continue;
+            if (!pageImage.copy(images[i], { r.x, r.y })) {
+                std::fprintf(stderr, "cannot place %s\n", inputs[i].name.c_str());
+                return 1;
+            }
+        }
+
+        const std::string pageName = "atlas_" + std::to_string(page) + ".png";
+        if (!pageImage.saveToFile(outputDir + "/" + pageName)) {
+            std::fprintf(stderr, "cannot write %s/%s\n", outputDir.c_str(), pageName.c_str());
+            return 1;
+        }
+        pageNames.push_back(pageName);
+        std::printf("%s: %ux%u\n", pageName.c_str(), pageExtent[page].x, pageExtent[page].y);
+    }
+
+    const std::string manifest = outputDir + "/atlas.txt";
+    if (!TextureAtlas::save(manifest, pageNames, inputs, layout)) {
+        std::fprintf(stderr, "cannot write %s\n", manifest.c_str());
+        return 1;
+    }
+    std::printf("%zu sprites -> %u page(s), %s\n", inputs.size(), layout.pages, manifest.c_str());
+    return 0;
+}
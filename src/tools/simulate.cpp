@@ -0,0 +1,85 @@
+// Headless-симуляция матчей "Drop it or Die" методом Монте-Карло
+//   simulate [--matches N] [--seed S] [--threads T] [--histogram]
+// При одинаковом seed результаты совпадают при любом числе потоков.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../sdk/hpp/match_simulator.h"
+#include "../sdk/hpp/odds_solver.h"
+
+static void usage() {
+    std::printf("usage: simulate [--matches N] [--seed S] [--threads T] [--histogram]\n");
+}
+
+int main(int argc, char** argv) {
+    SimulationConfig config;
+    bool showHistogram = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--matches") && hasValue) {
+            config.matches = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--seed") && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--threads") && hasValue) {
+            config.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!std::strcmp(argv[i], "--histogram")) {
+            showHistogram = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    const SimulationStats stats = MatchSimulator::run(config);
+    if (stats.matches == 0) {
+        usage();
+        return 1;
+    }
+
+    const double matches = static_cast<double>(stats.matches);
+    const double rounds = static_cast<double>(stats.rounds);
+    const double winRate = stats.pl1Survived / matches;
+    const double margin = 1.96 * std::sqrt(winRate * (1 - winRate) / matches);
+    const OddsState start;
+
+    std::printf("matches      %llu (seed %llu, %u threads)\n",
+                (unsigned long long)stats.matches, (unsigned long long)config.seed, stats.threads);
+    std::printf("rounds       %llu (%.3f per match, exact %.3f)\n", (unsigned long long)stats.rounds,
+                rounds / matches, OddsSolver::expectedRounds(start));
+    std::printf("time         %.3f s, %.1f M rounds/s, %.1f M matches/s\n",
+                stats.seconds, rounds / stats.seconds / 1e6, matches / stats.seconds / 1e6);
+    std::printf("pl1 survives %.6f +- %.6f (95%%), exact %.6f\n", winRate, margin, OddsSolver::pl1Survives(start));
+    std::printf("shots        %llu (%.3f per match)\n", (unsigned long long)stats.shots, stats.shots / matches);
+    std::printf("round        pl1 win %.6f | pl2 win %.6f | draw %.6f\n",
+                stats.roundOutcomes[0] / rounds, stats.roundOutcomes[1] / rounds, stats.roundOutcomes[2] / rounds);
+    std::printf("round exact  pl1 win %.6f | pl2 win %.6f | draw %.6f\n",
+                DiceOdds::pWin, DiceOdds::pLose, DiceOdds::pDraw);
+
+    // Перцентили длины матча по гистограмме
+    const double percentiles[] = { 0.5, 0.9, 0.99 };
+    for (double p : percentiles) {
+        uint64_t seen = 0;
+        size_t bucket = 0;
+        for (; bucket < stats.matchLength.size(); ++bucket) {
+            seen += stats.matchLength[bucket];
+            if (seen >= p * matches) break;
+        }
+        std::printf("length p%-4g %s%zu rounds\n", p * 100,
+                    bucket + 1 >= SimulationStats::histogramSize ? ">=" : "", bucket);
+    }
+
+    if (showHistogram) {
+        std::printf("\nrounds  matches\n");
+        for (size_t i = 0; i < stats.matchLength.size(); ++i) {
+            if (!stats.matchLength[i]) continue;
+            std::printf("%s%-5zu %llu\n", i + 1 == SimulationStats::histogramSize ? ">=" : "  ",
+                        i, (unsigned long long)stats.matchLength[i]);
+        }
+    }
+
+    return 0;
+}
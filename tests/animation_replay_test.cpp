@@ -0,0 +1,109 @@
+// Повторяемость анимаций: один и тот же сценарий на часах FixedStep/Manual даёт побитово те же позиции виджетов.
+//   animation_replay_test
+// Headless: виджеты без окна, время - подменённый источник (FixedStep) или AnimationSystem::step (Manual).
+// Шаг 1/64 и кадры кратные ему - аккумулятор считает точно, так что разная нарезка кадров даёт те же шаги.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../src/sdk/hpp/animation_system.h"
+#include "check.h"
+
+static constexpr double step = 1.0 / 64;
+
+// Все easing, цепочка ключевых кадров, отложенный старт, callback с новой анимацией и таймер
+static std::vector<tgui::Widget::Ptr> scenario() {
+    std::vector<tgui::Widget::Ptr> widgets;
+    for (size_t i = 0; i < EasingFunctions::typeCount + 3; ++i) {
+        widgets.push_back(tgui::ClickableWidget::create());
+        widgets.back()->setPosition(static_cast<float>(i) * 10, 5);
+    }
+    for (size_t i = 0; i < EasingFunctions::typeCount; ++i) {
+        AnimationSystem::move(widgets[i], { 300.0f + i, 200.0f - i }, 0.7f + 0.1f * i, static_cast<EasingType>(i));
+    }
+
+    const size_t extra = EasingFunctions::typeCount;
+    AnimationSystem::sequence(widgets[extra], { { 50, 50 }, { 120, 10 }, { 0, 90 } }, 0.33f, EasingType::EaseInOut);
+    AnimationSystem::moveAfter(0.41, widgets[extra + 1], { 77, 33 }, 0.5f, EasingType::ElasticOut);
+
+    tgui::Widget::Ptr last = widgets[extra + 2];
+    AnimationSystem::moveWithCallback(last, { 10, 400 }, 0.6f, [last] {
+        AnimationSystem::move(last, { 400, 10 }, 0.45f, EasingType::BounceOut);
+    }, EasingType::BackOut);
+    AnimationSystem::after(0.9, [last] { AnimationSystem::move(last, { 5, 5 }, 0.3f, EasingType::EaseIn); });
+    return widgets;
+}
+
+// Позиции всех виджетов как биты float - сравнение без допуска
+static void record(const std::vector<tgui::Widget::Ptr>& widgets, std::vector<uint32_t>& out) {
+    for (const tgui::Widget::Ptr& widget : widgets) {
+        const tgui::Vector2f position = widget->getPosition();
+        uint32_t bits[2];
+        std::memcpy(&bits[0], &position.x, sizeof(float));
+        std::memcpy(&bits[1], &position.y, sizeof(float));
+        out.insert(out.end(), bits, bits + 2);
+    }
+}
+
+// FixedStep: кадры длиной frames[i] шагов; позиции после каждого кадра и в конце
+static std::vector<uint32_t> runFixed(const std::vector<int>& frames, std::vector<uint32_t>* final = nullptr) {
+    double source = 0;
+    AnimationSystem::initialize(ClockMode::FixedStep, step);
+    AnimationSystem::setTimeSource([&source] { return source; });
+    const std::vector<tgui::Widget::Ptr> widgets = scenario();
+
+    std::vector<uint32_t> positions;
+    for (int steps : frames) {
+        source += steps * step;
+        AnimationSystem::updateAnimations();
+        record(widgets, positions);
+    }
+    if (final) record(widgets, *final);
+
+    AnimationSystem::shutdown();
+    AnimationSystem::setTimeSource(nullptr);
+    return positions;
+}
+
+static std::vector<uint32_t> runManual(int frames) {
+    AnimationSystem::initialize(ClockMode::Manual);
+    const std::vector<tgui::Widget::Ptr> widgets = scenario();
+
+    std::vector<uint32_t> positions;
+    for (int i = 0; i < frames; ++i) {
+        AnimationSystem::step(1.0 / 60);
+        record(widgets, positions);
+    }
+    AnimationSystem::shutdown();
+    return positions;
+}
+
+int main() {
+    // Ровные кадры по шагу - 2.5 с сценария целиком
+    const std::vector<int> even(160, 1);
+    const std::vector<uint32_t> first = runFixed(even);
+    const std::vector<uint32_t> second = runFixed(even);
+    CHECK(first.size() == second.size() && first == second);
+
+    // Рваные кадры (0-3 шага, в сумме столько же) - итоговые позиции те же, что у ровных
+    std::vector<int> jittered;
+    int total = 0;
+    for (int i = 0; total < 160; ++i) {
+        const int steps = std::min((i * 7) % 4, 160 - total);
+        jittered.push_back(steps);
+        total += steps;
+    }
+    std::vector<uint32_t> evenFinal, jitteredFinal;
+    runFixed(even, &evenFinal);
+    runFixed(jittered, &jitteredFinal);
+    CHECK(evenFinal == jitteredFinal);
+
+    // Что-то действительно двигалось
+    std::vector<uint32_t> start;
+    record(scenario(), start);
+    CHECK(evenFinal != start);
+
+    CHECK(runManual(150) == runManual(150));
+    return Check::result();
+}
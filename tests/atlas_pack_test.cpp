@@ -0,0 +1,90 @@
+// Упаковка настоящих ассетов игры: то же, что делает tools/pack_atlas с настройками по умолчанию, без записи страниц.
+//   atlas_pack_test [ASSETS]   (по умолчанию ./src/assets - запуск из корня репозитория)
+// Размеры берутся из заголовка PNG, картинки не декодируются. Проверяется, что всё влезает в страницы 2048
+// с отступом 2, кадры каждого клипа и виды частиц из AtlasLayout::defaultGroups() лежат на одной странице.
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../src/sdk/hpp/frame_animation.h"
+#include "../src/sdk/hpp/texture_atlas.h"
+#include "check.h"
+
+namespace fs = std::filesystem;
+
+// Ширина и высота из IHDR: 8 байт сигнатуры, длина и тип чанка, затем два big-endian uint32
+static bool pngSize(const fs::path& path, unsigned& width, unsigned& height) {
+    FILE* file = std::fopen(path.string().c_str(), "rb");
+    if (!file) return false;
+    unsigned char header[24];
+    const bool read = std::fread(header, 1, sizeof(header), file) == sizeof(header);
+    std::fclose(file);
+    if (!read || header[1] != 'P' || header[2] != 'N' || header[3] != 'G') return false;
+    auto be32 = [&](size_t at) {
+        return (unsigned(header[at]) << 24) | (unsigned(header[at + 1]) << 16) | (unsigned(header[at + 2]) << 8) | header[at + 3];
+    };
+    width = be32(16);
+    height = be32(20);
+    return true;
+}
+
+static const AtlasRegion* regionOf(const std::vector<AtlasLayout::Input>& inputs, const AtlasLayout& layout, const std::string& name) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i].name == name) return &layout.regions[i];
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    const std::string assets = argc > 1 ? argv[1] : "./src/assets";
+    const fs::path inputDir = assets + "/textures/game";
+
+    std::vector<fs::path> files;
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(inputDir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".png") files.push_back(entry.path());
+    }
+    if (!CHECK(!files.empty())) return Check::result();
+
+    std::vector<AtlasLayout::Input> inputs;
+    for (const fs::path& file : files) {
+        unsigned width = 0, height = 0;
+        CHECK(pngSize(file, width, height));
+        fs::path name = fs::relative(file, inputDir);
+        name.replace_extension();
+        inputs.push_back({ name.generic_string(), width, height });
+    }
+
+    // Группы - как в pack_atlas по умолчанию
+    std::vector<FrameClipSource> clips;
+    CHECK(FrameClipSource::load(assets + "/animations/clips.txt", clips));
+    for (const FrameClipSource& clip : clips) {
+        std::vector<std::string> frames;
+        for (const FrameClipSource::Frame& frame : clip.frames) frames.push_back(frame.sprite);
+        CHECK(AtlasLayout::group(inputs, frames) == 0);
+    }
+    for (const std::string& folder : AtlasLayout::defaultGroups()) CHECK(AtlasLayout::groupFolder(inputs, folder));
+
+    AtlasLayout layout;
+    if (!CHECK(AtlasLayout::build(inputs, 2048, 2, layout))) return Check::result();
+    std::printf("%zu sprites -> %u page(s)\n", inputs.size(), layout.pages);
+
+    for (const FrameClipSource& clip : clips) {
+        const AtlasRegion* first = regionOf(inputs, layout, clip.frames.front().sprite);
+        for (const FrameClipSource::Frame& frame : clip.frames) {
+            const AtlasRegion* region = regionOf(inputs, layout, frame.sprite);
+            CHECK(first && region && region->page == first->page);
+        }
+    }
+    for (const std::string& folder : AtlasLayout::defaultGroups()) {
+        const AtlasRegion* first = nullptr;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (fs::path(inputs[i].name).parent_path().generic_string() != folder) continue;
+            if (!first) first = &layout.regions[i];
+            CHECK(layout.regions[i].page == first->page);
+        }
+    }
+    return Check::result();
+}
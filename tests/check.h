@@ -0,0 +1,28 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+// Минимум для headless-проверок: CHECK(условие) печатает место провала и считает его,
+// main() возвращает Check::result() - 0, если всё прошло
+#include <cstdio>
+
+namespace Check {
+    inline int failures = 0;
+
+    inline bool report(bool ok, const char* expression, const char* file, int line) {
+        if (!ok) {
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+            ++failures;
+        }
+        return ok;
+    }
+
+    inline int result() {
+        if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+        else std::printf("ok\n");
+        return failures ? 1 : 0;
+    }
+}
+
+#define CHECK(condition) Check::report(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,50 @@
+// Горячий путь игры без кучи: GameCore::step и reset не аллоцируют (подменённые new/delete из alloc_tracker.h).
+//   game_core_alloc_test
+// Заодно проверяется, что сверхвыровненные объекты (alignas(32) DiceBatch) тоже попадают в счётчики.
+
+#define ALLOC_TRACKER_HOOK
+#include "../src/sdk/hpp/alloc_tracker.h"
+
+#include <memory>
+
+#include "../src/sdk/hpp/game_core.h"
+#include "check.h"
+
+int main() {
+    CHECK(AllocTracker::hooked() || (std::make_unique<int>(0), AllocTracker::hooked()));
+
+    FastRandom rng(12345);
+    GameState state;
+    GameCore::reset(state, rng);
+
+    // 100k раундов - несколько сотен матчей, все ветки исхода и выстрелов
+    AllocTracker::setBudget("game_step", 0);
+    const uint64_t before = AllocTracker::totalAllocations();
+    uint64_t matches = 0;
+    {
+        ALLOC_SCOPE("game_step");
+        for (int i = 0; i < 100000; ++i) {
+            if (state.over()) {
+                GameCore::reset(state, rng);
+                ++matches;
+            }
+            GameCore::step(state, rng);
+        }
+    }
+    CHECK(AllocTracker::totalAllocations() == before);
+    CHECK(AllocTracker::overBudgetCount() == 0);
+    CHECK(matches > 0);
+
+    // После конца матча step ничего не бросает
+    while (!state.over()) GameCore::step(state, rng);
+    const GameState finished = state;
+    CHECK(GameCore::step(state, rng) == GameEvent::MatchOver);
+    CHECK(std::memcmp(&finished, &state, sizeof(GameState)) == 0);
+
+    // DiceBatch идёт через align_val_t-перегрузку new
+    const uint64_t beforeBatch = AllocTracker::totalAllocations();
+    auto batch = std::make_unique<DiceBatch>();
+    CHECK(AllocTracker::totalAllocations() == beforeBatch + 1);
+    CHECK(reinterpret_cast<std::uintptr_t>(batch.get()) % alignof(DiceBatch) == 0);
+    return Check::result();
+}